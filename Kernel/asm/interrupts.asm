@@ -12,6 +12,7 @@ GLOBAL _irq03Handler
 GLOBAL _irq04Handler
 GLOBAL _irq05Handler
 GLOBAL _syscallHandler
+GLOBAL syscallFrame
 
 GLOBAL _ex00Handler
 GLOBAL _ex06Handler
@@ -23,6 +24,8 @@ EXTERN syscallDispatcher
 EXTERN exceptionDispatcher
 EXTERN load_main
 EXTERN schedule
+EXTERN getCurrentPageTable
+EXTERN pageFaultDispatcher
 
 SECTION .text
 
@@ -152,7 +155,16 @@ _irq00Handler:
 
 	mov rdi, rsp
 	call schedule
-	mov rsp, rax
+	mov rbx, rax
+
+	; El stack del proximo proceso solo existe en su espacio de direcciones: hay que cambiar CR3 antes que RSP
+	call getCurrentPageTable
+	mov rcx, cr3
+	cmp rax, rcx
+	je .sameAddressSpace
+	mov cr3, rax
+.sameAddressSpace:
+	mov rsp, rbx
 
 	mov al, 20h
 	out 20h, al
@@ -184,6 +196,7 @@ _irq05Handler:
 _syscallHandler:
 	pushState
 	mov rbp, rsp
+	mov [syscallFrame], rsp ; registros del proceso y frame del iretq, fork los reusa para el hijo
 
 	push r9
 	mov r9, r8
@@ -216,8 +229,21 @@ _ex06Handler:
 _ex0DHandler:
 	exceptionHandler 13
 
-; Page Fault
+; Page Fault: el CPU agrega un codigo de error arriba del frame. Si la pagina es de las que se mapean al
+; tocarlas se reintenta la instruccion; si no, se descarta el codigo y se sigue como en las demas excepciones
 _ex0EHandler:
+	pushState
+	mov rdi, cr2
+	mov rsi, [rsp + 15*8] ; codigo de error
+	call pageFaultDispatcher
+	cmp rax, 0
+	jne .fatal
+	popState
+	add rsp, 8
+	iretq
+.fatal:
+	popState
+	add rsp, 8
 	exceptionHandler 14
 
 haltcpu:
@@ -226,4 +252,5 @@ haltcpu:
 	ret
 
 SECTION .bss
-	aux resq 1
\ No newline at end of file
+	aux resq 1
+	syscallFrame resq 1
\ No newline at end of file
@@ -8,6 +8,13 @@ GLOBAL saveRegisters
 GLOBAL callTimerTick
 GLOBAL _xadd
 GLOBAL _xchg
+GLOBAL _rdtsc
+GLOBAL _readCR3
+GLOBAL _writeCR3
+GLOBAL _invlpg
+GLOBAL _enableWriteProtect
+GLOBAL _loadGdt
+GLOBAL _loadTr
 
 section .text
     
@@ -92,4 +99,36 @@ _xadd:
 _xchg:
   mov rax, rsi
   xchg [rdi], eax
-  ret
\ No newline at end of file
+  ret
+
+_rdtsc:
+  rdtsc
+  shl rdx, 32
+  or rax, rdx
+  ret
+
+_readCR3:
+  mov rax, cr3
+  ret
+
+_writeCR3:
+  mov cr3, rdi
+  ret
+
+_invlpg:
+  invlpg [rdi]
+  ret
+
+_enableWriteProtect:
+  mov rax, cr0
+  or rax, 1 << 16
+  mov cr0, rax
+  ret
+
+_loadGdt:
+  lgdt [rdi]
+  ret
+
+_loadTr:
+  ltr di
+  ret
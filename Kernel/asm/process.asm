@@ -9,7 +9,7 @@ setupStackFrame:
     mov rsp, rdi ; stack base
     and rsp, -16
     push 0x0
-    push rdi
+    push r8 ; rsp con el que arranca el proceso, en su propio espacio de direcciones
     push 0x202
     push 0x8
     push rsi
@@ -0,0 +1,222 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+/*
+ * Benchmark de memset y memcpy corriendo en Linux. Compara las rutinas de Shared/memops.c con las que tenian antes el
+ * kernel y userland (copiadas aca) y con las de la libc del host, con buffers alineados y desalineados.
+ * Shared/memops.c se compila renombrando sus funciones para no chocar con las de la libc.
+ * Uso: make membench [BENCH_MEM_MB=<n>]
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define DEFAULT_MEM_MB 256			   /* Bytes totales que se copian o escriben por cada medicion */
+#define SCROLL_SIZE (1024 * 3 * 752) /* Lo que mueve printNewline en una pantalla de 1024x768 con fuente de 16 */
+#define MAX_SIZE SCROLL_SIZE
+#define CHECK_SIZE 300
+
+void *sharedMemset(void *destination, int32_t character, uint64_t length);
+void *sharedMemcpy(void *destination, const void *source, uint64_t length);
+
+typedef void *(*setRoutine)(void *destination, int32_t c, uint64_t length);
+typedef void *(*copyRoutine)(void *destination, const void *source, uint64_t length);
+
+static void *legacyMemset(void *destination, int32_t c, uint64_t length);
+static void *legacyMemcpy(void *destination, const void *source, uint64_t length);
+static void *libcMemset(void *destination, int32_t c, uint64_t length);
+static void *libcMemcpy(void *destination, const void *source, uint64_t length);
+static int check(void);
+static uint64_t now(void);
+static double benchSet(setRoutine set, uint8_t *dst, uint64_t size, uint64_t total);
+static double benchCopy(copyRoutine copy, uint8_t *dst, const uint8_t *src, uint64_t size, uint64_t total);
+
+static const uint64_t sizes[] = {16, 64, 256, 4096, 65536, SCROLL_SIZE};
+
+static const struct {
+	const char *name;
+	setRoutine set;
+	copyRoutine copy;
+} routines[] = {
+	{"anterior", legacyMemset, legacyMemcpy},
+	{"memops", sharedMemset, sharedMemcpy},
+	{"libc", libcMemset, libcMemcpy},
+};
+
+/* volatile para que el compilador no descarte las llamadas de la medicion */
+static volatile uint8_t sink;
+
+int main(int argc, char **argv) {
+	uint64_t totalMb = argc > 1 ? strtoull(argv[1], NULL, 10) : DEFAULT_MEM_MB;
+	if (totalMb == 0) {
+		fprintf(stderr, "Uso: %s [mb_por_medicion]\n", argv[0]);
+		return 1;
+	}
+	if (check() == -1) {
+		return 1;
+	}
+
+	uint8_t *src = malloc(MAX_SIZE + 64);
+	uint8_t *dst = malloc(MAX_SIZE + 64);
+	if (src == NULL || dst == NULL) {
+		fprintf(stderr, "No se pudieron reservar los buffers\n");
+		return 1;
+	}
+	memset(src, 0x5A, MAX_SIZE + 64);
+	memset(dst, 0, MAX_SIZE + 64);
+
+	uint64_t total = totalMb * 1024 * 1024;
+	printf("MiB por medicion=%lu, resultados en GiB/s\n", (unsigned long) totalMb);
+	printf("%-9s %-10s %10s", "rutina", "alineacion", "");
+	for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+		printf(" %9lu", (unsigned long) sizes[i]);
+	}
+	printf("\n");
+
+	for (int misaligned = 0; misaligned <= 1; misaligned++) {
+		// Desalineados: el destino corrido 1 byte y la fuente 3, como quedan los buffers de texto
+		uint8_t *d = dst + (misaligned ? 1 : 0);
+		uint8_t *s = src + (misaligned ? 3 : 0);
+		for (size_t r = 0; r < sizeof(routines) / sizeof(routines[0]); r++) {
+			printf("%-9s %-10s %10s", routines[r].name, misaligned ? "no" : "si", "memset");
+			for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+				printf(" %9.2f", benchSet(routines[r].set, d, sizes[i], total));
+			}
+			printf("\n%-9s %-10s %10s", "", "", "memcpy");
+			for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+				printf(" %9.2f", benchCopy(routines[r].copy, d, s, sizes[i], total));
+			}
+			printf("\n");
+		}
+	}
+
+	free(src);
+	free(dst);
+	return 0;
+}
+
+/**
+ * @brief Compara memops contra la libc para todos los tamaños chicos y desplazamientos, incluido el solapamiento
+ *        hacia adelante que usa el scroll
+ */
+static int check(void) {
+	static uint8_t buffer[2 * CHECK_SIZE + 64], expected[2 * CHECK_SIZE + 64], source[CHECK_SIZE + 64];
+	for (size_t i = 0; i < sizeof(source); i++) {
+		source[i] = (uint8_t) (i * 7 + 1);
+	}
+
+	for (uint64_t length = 0; length <= CHECK_SIZE; length++) {
+		for (uint64_t offset = 0; offset < 16; offset++) {
+			memset(buffer, 0xEE, sizeof(buffer));
+			memset(expected, 0xEE, sizeof(expected));
+			sharedMemcpy(buffer + offset, source + (15 - offset), length);
+			memcpy(expected + offset, source + (15 - offset), length);
+			if (memcmp(buffer, expected, sizeof(buffer)) != 0) {
+				fprintf(stderr, "memcpy fallo: largo %lu desplazamiento %lu\n", (unsigned long) length,
+						(unsigned long) offset);
+				return -1;
+			}
+
+			sharedMemset(buffer + offset, (int32_t) (length + 0x100), length);
+			memset(expected + offset, (int) (length + 0x100), length);
+			if (memcmp(buffer, expected, sizeof(buffer)) != 0) {
+				fprintf(stderr, "memset fallo: largo %lu desplazamiento %lu\n", (unsigned long) length,
+						(unsigned long) offset);
+				return -1;
+			}
+
+			for (uint64_t distance = 8; distance < 24; distance++) {
+				for (size_t i = 0; i < sizeof(buffer); i++) {
+					buffer[i] = expected[i] = (uint8_t) (i * 13);
+				}
+				sharedMemcpy(buffer + offset, buffer + offset + distance, length);
+				memmove(expected + offset, expected + offset + distance, length);
+				if (memcmp(buffer, expected, sizeof(buffer)) != 0) {
+					fprintf(stderr, "memcpy solapado fallo: largo %lu distancia %lu\n", (unsigned long) length,
+							(unsigned long) distance);
+					return -1;
+				}
+			}
+		}
+	}
+	return 0;
+}
+
+static double benchSet(setRoutine set, uint8_t *dst, uint64_t size, uint64_t total) {
+	uint64_t rounds = total / size;
+	uint64_t start = now();
+	for (uint64_t i = 0; i < rounds; i++) {
+		set(dst, (int32_t) i, size);
+		sink = dst[size - 1];
+	}
+	uint64_t elapsed = now() - start;
+	return (double) (rounds * size) / (double) elapsed * 1e9 / (1024.0 * 1024.0 * 1024.0);
+}
+
+static double benchCopy(copyRoutine copy, uint8_t *dst, const uint8_t *src, uint64_t size, uint64_t total) {
+	uint64_t rounds = total / size;
+	uint64_t start = now();
+	for (uint64_t i = 0; i < rounds; i++) {
+		copy(dst, src, size);
+		sink = dst[size - 1];
+	}
+	uint64_t elapsed = now() - start;
+	return (double) (rounds * size) / (double) elapsed * 1e9 / (1024.0 * 1024.0 * 1024.0);
+}
+
+static uint64_t now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+static void *libcMemset(void *destination, int32_t c, uint64_t length) {
+	return memset(destination, c, length);
+}
+
+static void *libcMemcpy(void *destination, const void *source, uint64_t length) {
+	return memcpy(destination, source, length);
+}
+
+/**
+ * @brief El memset que tenian Kernel/lib.c y el _loader.c de userland
+ */
+static void *legacyMemset(void *destination, int32_t c, uint64_t length) {
+	uint8_t chr = (uint8_t) c;
+	char *dst = (char *) destination;
+
+	while (length--)
+		dst[length] = chr;
+
+	return destination;
+}
+
+/**
+ * @brief El memcpy que tenia Kernel/lib.c
+ */
+static void *legacyMemcpy(void *destination, const void *source, uint64_t length) {
+	uint64_t i;
+
+	if ((uint64_t) destination % sizeof(uint32_t) == 0 && (uint64_t) source % sizeof(uint32_t) == 0 &&
+		length % sizeof(uint32_t) == 0) {
+		uint32_t *d = (uint32_t *) destination;
+		const uint32_t *s = (const uint32_t *) source;
+
+		for (i = 0; i < length / sizeof(uint32_t); i++)
+			d[i] = s[i];
+	}
+	else {
+		uint8_t *d = (uint8_t *) destination;
+		const uint8_t *s = (const uint8_t *) source;
+
+		for (i = 0; i < length; i++)
+			d[i] = s[i];
+	}
+
+	return destination;
+}
@@ -0,0 +1,288 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+/*
+ * Benchmark de los memory managers corriendo en Linux. Se compila una vez por cada MM_TYPE junto con
+ * utils/memory/<MM_TYPE>.c y administra un arena pedida con el malloc del host, asi que no hace falta QEMU.
+ * Uso: make mmbench [BENCH_OPS=<n>] [BENCH_ARENA_MB=<n>]
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "../include/memoryManagement.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifndef MM_NAME
+#define MM_NAME "?"
+#endif
+
+#define DEFAULT_OPS 200000
+#define DEFAULT_ARENA_MB 32
+#define MAX_LIVE 4096		 /* Bloques vivos simultaneos como maximo en cada traza */
+#define SAMPLE_INTERVAL 1024 /* Cada cuantas operaciones se mide la fragmentacion */
+#define SMALL_MAX 512
+#define MEDIUM_MAX 8192
+#define LARGE_MAX (128 * 1024)
+
+typedef struct BenchResult {
+	uint64_t ops;
+	uint64_t attempts;
+	uint64_t failures;
+	uint64_t nanos;
+	uint64_t allocNanos;
+	uint64_t freeNanos;
+	uint64_t frees;
+	uint64_t peakFragmentation; // en porcentaje
+} BenchResult;
+
+typedef void (*trace)(BenchResult *result, uint64_t ops);
+
+static void *arena;
+static uint64_t arenaSize;
+static uint64_t seed;
+
+static void *slots[MAX_LIVE];
+static uint64_t slotCount;
+
+static uint64_t nextRandom(void);
+static uint64_t randomSize(void);
+static uint64_t now(void);
+static void resetManager(void);
+static void *benchAlloc(BenchResult *result, uint64_t size);
+static void benchFree(BenchResult *result, void *ptr);
+static void sampleFragmentation(BenchResult *result);
+static void releaseAll(BenchResult *result);
+static void traceRandom(BenchResult *result, uint64_t ops);
+static void traceLifo(BenchResult *result, uint64_t ops);
+static void traceProducerConsumer(BenchResult *result, uint64_t ops);
+static void traceFragmenting(BenchResult *result, uint64_t ops);
+
+static const struct {
+	const char *name;
+	trace run;
+} traces[] = {
+	{"random", traceRandom},
+	{"lifo", traceLifo},
+	{"prod/cons", traceProducerConsumer},
+	{"fragmenting", traceFragmenting},
+};
+
+int main(int argc, char **argv) {
+	uint64_t ops = argc > 1 ? strtoull(argv[1], NULL, 10) : DEFAULT_OPS;
+	uint64_t arenaMb = argc > 2 ? strtoull(argv[2], NULL, 10) : DEFAULT_ARENA_MB;
+	if (ops == 0 || arenaMb == 0) {
+		fprintf(stderr, "Uso: %s [ops] [arena_mb]\n", argv[0]);
+		return 1;
+	}
+
+	arenaSize = arenaMb * 1024 * 1024;
+	arena = malloc(arenaSize);
+	if (arena == NULL) {
+		fprintf(stderr, "No se pudo reservar el arena de %lu MiB\n", (unsigned long) arenaMb);
+		return 1;
+	}
+
+	printf("MM_TYPE=%s arena=%lu MiB ops=%lu\n", MM_NAME, (unsigned long) arenaMb, (unsigned long) ops);
+
+	// Primero se tocan todas las paginas del arena para que mm_create no pague los page faults del host
+	memset(arena, 0xA5, arenaSize);
+	uint64_t start = now();
+	resetManager();
+	printf("mm_create: %.1f us\n", (double) (now() - start) / 1000.0);
+	printf("%-12s %10s %10s %10s %10s %12s %10s\n", "trace", "ops", "ns/op", "alloc ns", "free ns", "peak frag", "fail");
+
+	for (size_t i = 0; i < sizeof(traces) / sizeof(traces[0]); i++) {
+		BenchResult result = {0};
+		seed = 0x5DEECE66DULL + i;
+		resetManager();
+		traces[i].run(&result, ops);
+		releaseAll(&result);
+
+		printf("%-12s %10lu %10.1f %10.1f %10.1f %11lu%% %9.2f%%\n", traces[i].name, (unsigned long) result.ops,
+			   result.ops ? (double) result.nanos / (double) result.ops : 0.0,
+			   result.attempts ? (double) result.allocNanos / (double) result.attempts : 0.0,
+			   result.frees ? (double) result.freeNanos / (double) result.frees : 0.0,
+			   (unsigned long) result.peakFragmentation,
+			   result.attempts ? 100.0 * (double) result.failures / (double) result.attempts : 0.0);
+	}
+
+	free(arena);
+	return 0;
+}
+
+/**
+ * @brief Generador xorshift64: las trazas tienen que ser identicas entre corridas y entre managers
+ */
+static uint64_t nextRandom(void) {
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return seed;
+}
+
+/**
+ * @brief Tamaño con la distribucion tipica de la shell: mayormente chico, a veces mediano y rara vez grande
+ */
+static uint64_t randomSize(void) {
+	uint64_t r = nextRandom() % 100;
+	if (r < 80) {
+		return 1 + nextRandom() % SMALL_MAX;
+	}
+	if (r < 98) {
+		return 1 + nextRandom() % MEDIUM_MAX;
+	}
+	return 1 + nextRandom() % LARGE_MAX;
+}
+
+static uint64_t now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+static void resetManager(void) {
+	slotCount = 0;
+	if (mm_create(arena, arenaSize) == NULL) {
+		fprintf(stderr, "mm_create fallo para %s\n", MM_NAME);
+		exit(1);
+	}
+}
+
+static void *benchAlloc(BenchResult *result, uint64_t size) {
+	uint64_t start = now();
+	void *ptr = mm_alloc(size);
+	uint64_t elapsed = now() - start;
+	result->nanos += elapsed;
+	result->allocNanos += elapsed;
+	result->ops++;
+	result->attempts++;
+	if (ptr == NULL) {
+		result->failures++;
+	}
+	else {
+		// Tocar el bloque detecta punteros fuera del arena y obliga al host a mapear las paginas
+		*(volatile uint8_t *) ptr = (uint8_t) size;
+	}
+	if (result->ops % SAMPLE_INTERVAL == 0) {
+		sampleFragmentation(result);
+	}
+	return ptr;
+}
+
+static void benchFree(BenchResult *result, void *ptr) {
+	uint64_t start = now();
+	mm_free(ptr);
+	uint64_t elapsed = now() - start;
+	result->nanos += elapsed;
+	result->freeNanos += elapsed;
+	result->frees++;
+	result->ops++;
+	if (result->ops % SAMPLE_INTERVAL == 0) {
+		sampleFragmentation(result);
+	}
+}
+
+/**
+ * @brief Fragmentacion externa: porcentaje de la memoria libre que no esta en el bloque libre mas grande
+ * @note  mm_stats recorre todos los metadatos, por eso queda afuera de la medicion de tiempo
+ */
+static void sampleFragmentation(BenchResult *result) {
+	mm_stats_t stats;
+	mm_stats(&stats);
+	if (stats.free == 0) {
+		return;
+	}
+	uint64_t fragmentation = 100 - (stats.largestFreeBlock * 100) / stats.free;
+	if (fragmentation > result->peakFragmentation) {
+		result->peakFragmentation = fragmentation;
+	}
+}
+
+static void releaseAll(BenchResult *result) {
+	for (uint64_t i = 0; i < slotCount; i++) {
+		if (slots[i] != NULL) {
+			benchFree(result, slots[i]);
+		}
+	}
+	slotCount = 0;
+}
+
+/**
+ * @brief Allocs y frees mezclados al azar sobre un conjunto de bloques vivos
+ */
+static void traceRandom(BenchResult *result, uint64_t ops) {
+	while (result->ops < ops) {
+		if (slotCount < MAX_LIVE && (slotCount == 0 || nextRandom() % 2 == 0)) {
+			slots[slotCount++] = benchAlloc(result, randomSize());
+		}
+		else {
+			uint64_t victim = nextRandom() % slotCount;
+			if (slots[victim] != NULL) {
+				benchFree(result, slots[victim]);
+			}
+			slots[victim] = slots[--slotCount];
+		}
+	}
+}
+
+/**
+ * @brief Rafagas de allocs que se liberan en orden inverso, como los buffers temporales de un comando
+ */
+static void traceLifo(BenchResult *result, uint64_t ops) {
+	while (result->ops < ops) {
+		uint64_t depth = 1 + nextRandom() % MAX_LIVE;
+		while (slotCount < depth) {
+			slots[slotCount++] = benchAlloc(result, randomSize());
+		}
+		while (slotCount > 0) {
+			void *ptr = slots[--slotCount];
+			if (ptr != NULL) {
+				benchFree(result, ptr);
+			}
+		}
+	}
+}
+
+/**
+ * @brief Cola FIFO: cada bloque nuevo libera al mas viejo una vez que la cola esta llena, como un pipe
+ */
+static void traceProducerConsumer(BenchResult *result, uint64_t ops) {
+	uint64_t head = 0;
+	while (result->ops < ops) {
+		if (slotCount == MAX_LIVE && slots[head] != NULL) {
+			benchFree(result, slots[head]);
+		}
+		slots[head] = benchAlloc(result, randomSize());
+		head = (head + 1) % MAX_LIVE;
+		if (slotCount < MAX_LIVE) {
+			slotCount++;
+		}
+	}
+}
+
+/**
+ * @brief Llena con bloques chicos, libera uno de cada dos y pide bloques grandes sobre los huecos
+ */
+static void traceFragmenting(BenchResult *result, uint64_t ops) {
+	while (result->ops < ops) {
+		while (slotCount < MAX_LIVE) {
+			slots[slotCount++] = benchAlloc(result, 1 + nextRandom() % SMALL_MAX);
+		}
+		for (uint64_t i = 0; i < slotCount; i += 2) {
+			if (slots[i] != NULL) {
+				benchFree(result, slots[i]);
+				slots[i] = NULL;
+			}
+		}
+		for (uint64_t i = 0; i < MAX_LIVE / 16; i++) {
+			void *ptr = benchAlloc(result, MEDIUM_MAX + nextRandom() % (LARGE_MAX - MEDIUM_MAX));
+			if (ptr != NULL) {
+				benchFree(result, ptr);
+			}
+		}
+		releaseAll(result);
+	}
+}
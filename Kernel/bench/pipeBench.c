@@ -0,0 +1,212 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+/*
+ * Throughput de los pipes corriendo en Linux. Se compila junto con utils/pipes/pipes.c, utils/pipes/objectTable.c y
+ * Shared/memops.c; el heap es el de la libc y las colas de espera son una version de un solo hilo que aborta si alguien
+ * tuviera que bloquearse, asi que cada escritura entra entera en el buffer y la lectura siguiente la vacia. Mide el
+ * costo de mover los datos, sin cambios de contexto, con la capacidad por defecto y con la maxima, y el de una etapa
+ * intermedia que pasa los datos de un pipe a otro con read + write o con splicePipe.
+ * Uso: make pipebench [BENCH_PIPE_MB=<n>]
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "../include/memoryManagement.h"
+#include "../include/pipes.h"
+#include "../include/semaphore.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define DEFAULT_PIPE_MB 64
+
+typedef struct waitQueueCDT {
+	int unused;
+} waitQueueCDT;
+
+static uint64_t now(void);
+static int benchPipe(int pipe, int capacity, uint64_t total);
+static int benchRelay(uint64_t total);
+static int relay(int first, int second, int chunk, int useSplice);
+
+static const int chunks[] = {1, 16, 64, 256, PIPE_DEFAULT_CAPACITY, 4096, PIPE_MAX_CAPACITY};
+
+static char in[PIPE_MAX_CAPACITY], out[PIPE_MAX_CAPACITY];
+
+int main(int argc, char **argv) {
+	uint64_t totalMb = argc > 1 ? strtoull(argv[1], NULL, 10) : DEFAULT_PIPE_MB;
+	if (totalMb == 0) {
+		fprintf(stderr, "Uso: %s [mb_por_medicion]\n", argv[0]);
+		return 1;
+	}
+
+	initializePipeManager();
+	int pipe = createPipe(0);
+	if (pipe < 0) {
+		fprintf(stderr, "No se pudo crear el pipe\n");
+		return 1;
+	}
+
+	for (int i = 0; i < PIPE_MAX_CAPACITY; i++) {
+		in[i] = (char) (i * 31 + 7);
+	}
+
+	uint64_t total = totalMb * 1024 * 1024;
+	printf("MiB por medicion=%lu\n", (unsigned long) totalMb);
+	if (benchPipe(pipe, PIPE_DEFAULT_CAPACITY, total) == -1) {
+		return 1;
+	}
+	if (setPipeCapacity(pipe, PIPE_MAX_CAPACITY) != PIPE_MAX_CAPACITY) {
+		fprintf(stderr, "No se pudo agrandar el pipe\n");
+		return 1;
+	}
+	if (benchPipe(pipe, PIPE_MAX_CAPACITY, total) == -1) {
+		return 1;
+	}
+	return benchRelay(total) == -1 ? 1 : 0;
+}
+
+/**
+ * @brief Mide el throughput con cada tamaño de bloque que entra en 'capacity'
+ */
+static int benchPipe(int pipe, int capacity, uint64_t total) {
+	printf("\nbuffer del pipe=%d bytes\n", capacity);
+	printf("%8s %12s\n", "bloque", "MB/s");
+	for (size_t c = 0; c < sizeof(chunks) / sizeof(chunks[0]) && chunks[c] <= capacity; c++) {
+		int chunk = chunks[c];
+		uint64_t rounds = total / chunk;
+		uint64_t start = now();
+		for (uint64_t i = 0; i < rounds; i++) {
+			// Cada vuelta arranca en otra posicion del buffer circular para pasar tambien por el borde
+			const char *data = in + i % (capacity - chunk + 1);
+			int written = 0;
+			while (written < chunk) {
+				written += writePipe(pipe, data + written, chunk - written, 0);
+			}
+			int read = 0;
+			while (read < chunk) {
+				int n = readPipe(pipe, out + read, chunk - read, 0);
+				if (n <= 0) {
+					fprintf(stderr, "El pipe devolvio %d\n", n);
+					return -1;
+				}
+				read += n;
+			}
+			if (memcmp(out, data, chunk) != 0) {
+				fprintf(stderr, "Los datos leidos no coinciden con los escritos (bloque %d)\n", chunk);
+				return -1;
+			}
+		}
+		uint64_t elapsed = now() - start;
+		printf("%8d %12.1f\n", chunk, (double) (rounds * chunk) / (double) elapsed * 1e3);
+	}
+	return 0;
+}
+
+/**
+ * @brief Mide una etapa intermedia: se escribe en un pipe, se pasa al otro y se lee del segundo
+ */
+static int benchRelay(uint64_t total) {
+	int first = createPipe(0);
+	int second = createPipe(0);
+	if (first < 0 || second < 0) {
+		fprintf(stderr, "No se pudieron crear los pipes\n");
+		return -1;
+	}
+
+	printf("\netapa intermedia, buffers de %d bytes\n", PIPE_DEFAULT_CAPACITY);
+	printf("%8s %14s %14s\n", "bloque", "read+write", "splice");
+	for (size_t c = 0; c < sizeof(chunks) / sizeof(chunks[0]) && chunks[c] <= PIPE_DEFAULT_CAPACITY; c++) {
+		int chunk = chunks[c];
+		double rates[2];
+		for (int useSplice = 0; useSplice <= 1; useSplice++) {
+			uint64_t rounds = total / chunk;
+			uint64_t start = now();
+			for (uint64_t i = 0; i < rounds; i++) {
+				const char *data = in + i % (PIPE_DEFAULT_CAPACITY - chunk + 1);
+				if (writePipe(first, data, chunk, 0) != chunk || relay(first, second, chunk, useSplice) == -1 ||
+					readPipe(second, out, chunk, 0) != chunk || memcmp(out, data, chunk) != 0) {
+					fprintf(stderr, "La etapa intermedia perdio datos (bloque %d)\n", chunk);
+					return -1;
+				}
+			}
+			rates[useSplice] = (double) (rounds * chunk) / (double) (now() - start) * 1e3;
+		}
+		printf("%8d %14.1f %14.1f\n", chunk, rates[0], rates[1]);
+	}
+	return 0;
+}
+
+/**
+ * @brief Pasa 'chunk' bytes del primer pipe al segundo como lo haria cat en medio de un pipeline
+ */
+static int relay(int first, int second, int chunk, int useSplice) {
+	static char bounce[PIPE_DEFAULT_CAPACITY];
+	int moved = 0;
+	while (moved < chunk) {
+		int n;
+		if (useSplice) {
+			n = splicePipe(first, second, chunk - moved, 0);
+		}
+		else {
+			n = readPipe(first, bounce, chunk - moved, 0);
+			if (n > 0 && writePipe(second, bounce, n, 0) != n) {
+				return -1;
+			}
+		}
+		if (n <= 0) {
+			return -1;
+		}
+		moved += n;
+	}
+	return 0;
+}
+
+static uint64_t now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+void *mm_alloc(size_t size) {
+	return malloc(size);
+}
+
+void mm_free(void *const restrict ptr) {
+	free(ptr);
+}
+
+void acquire(uint8_t *lock) {
+	*lock = 1;
+}
+
+void release(uint8_t *lock) {
+	*lock = 0;
+}
+
+waitQueueADT createWaitQueue() {
+	return malloc(sizeof(waitQueueCDT));
+}
+
+void freeWaitQueue(waitQueueADT queue) {
+	free(queue);
+}
+
+int waitQueueSleep(waitQueueADT queue, uint8_t *lock) {
+	fprintf(stderr, "El pipe se bloquearia: el benchmark no tiene otro proceso que lo despierte\n");
+	exit(1);
+}
+
+int waitQueueWakeAll(waitQueueADT queue) {
+	return 0;
+}
+
+int waitQueueAdd(waitQueueADT queue, int16_t pid) {
+	return 0;
+}
+
+void waitQueueRemove(waitQueueADT queue, int16_t pid) {
+}
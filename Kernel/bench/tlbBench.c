@@ -0,0 +1,134 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+/*
+ * Microbenchmark de paginas de 4 KiB contra paginas de 2 MiB corriendo en Linux. Recorre al azar una region del
+ * tamaño del heap siguiendo punteros, asi que casi todos los accesos caen en una pagina distinta y fallan en la TLB.
+ * La region se mapea una vez con paginas chicas y otra con paginas grandes (transparent huge pages via madvise).
+ * Uso: make tlbbench [BENCH_HEAP_MB=<n>] [BENCH_STEPS=<n>]
+ */
+
+#define _GNU_SOURCE
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+
+#define DEFAULT_HEAP_MB 256
+#define DEFAULT_STEPS 20000000
+#define LARGE_PAGE_SIZE (2UL * 1024 * 1024)
+#define STRIDE 64 /* Un nodo de la cadena por linea de cache */
+
+static uint64_t seed = 0x5DEECE66DULL;
+
+static uint64_t nextRandom(void);
+static uint64_t now(void);
+static uint64_t hugePagesKb(void);
+static int run(const char *name, int advice, uint64_t size, uint64_t steps);
+
+int main(int argc, char **argv) {
+	uint64_t heapMb = argc > 1 ? strtoull(argv[1], NULL, 10) : DEFAULT_HEAP_MB;
+	uint64_t steps = argc > 2 ? strtoull(argv[2], NULL, 10) : DEFAULT_STEPS;
+	if (heapMb == 0 || steps == 0) {
+		fprintf(stderr, "Uso: %s [heap_mb] [pasos]\n", argv[0]);
+		return 1;
+	}
+
+	printf("region=%lu MiB pasos=%lu\n", (unsigned long) heapMb, (unsigned long) steps);
+	printf("%-8s %12s %16s\n", "paginas", "ns/acceso", "huge pages MiB");
+
+	uint64_t size = heapMb * 1024 * 1024;
+	if (run("4 KiB", MADV_NOHUGEPAGE, size, steps) == -1 || run("2 MiB", MADV_HUGEPAGE, size, steps) == -1) {
+		return 1;
+	}
+	return 0;
+}
+
+/**
+ * @brief Mapea la region con el consejo pedido, arma una cadena aleatoria que la recorre entera y mide el recorrido
+ * @note  La cadena es un unico ciclo (algoritmo de Sattolo) para que el recorrido no se quede en un pedazo chico
+ */
+static int run(const char *name, int advice, uint64_t size, uint64_t steps) {
+	// Se pide de mas para poder alinear a 2 MiB, si no el kernel no puede usar paginas grandes en los bordes
+	uint8_t *mapping = mmap(NULL, size + LARGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (mapping == MAP_FAILED) {
+		fprintf(stderr, "No se pudo mapear la region de %lu bytes\n", (unsigned long) size);
+		return -1;
+	}
+	uint8_t *region = (uint8_t *) (((uintptr_t) mapping + LARGE_PAGE_SIZE - 1) & ~(LARGE_PAGE_SIZE - 1));
+	madvise(region, size, advice);
+	memset(region, 0, size);
+
+	uint64_t nodes = size / STRIDE;
+	uint32_t *order = malloc(nodes * sizeof(uint32_t));
+	if (order == NULL) {
+		fprintf(stderr, "No hay memoria para la permutacion\n");
+		munmap(mapping, size + LARGE_PAGE_SIZE);
+		return -1;
+	}
+	for (uint64_t i = 0; i < nodes; i++) {
+		order[i] = (uint32_t) i;
+	}
+	for (uint64_t i = nodes - 1; i > 0; i--) {
+		uint64_t j = nextRandom() % i;
+		uint32_t aux = order[i];
+		order[i] = order[j];
+		order[j] = aux;
+	}
+	for (uint64_t i = 0; i < nodes; i++) {
+		*(void **) (region + (uint64_t) order[i] * STRIDE) = region + (uint64_t) order[(i + 1) % nodes] * STRIDE;
+	}
+	free(order);
+
+	void **cursor = (void **) region;
+	for (uint64_t i = 0; i < nodes && i < steps; i++) {
+		cursor = *cursor;
+	}
+
+	uint64_t start = now();
+	for (uint64_t i = 0; i < steps; i++) {
+		cursor = *cursor;
+	}
+	uint64_t elapsed = now() - start;
+
+	// Se usa el cursor para que el compilador no descarte el recorrido
+	printf("%-8s %12.1f %16lu%s\n", name, (double) elapsed / (double) steps, (unsigned long) (hugePagesKb() / 1024),
+		   cursor == NULL ? "!" : "");
+	munmap(mapping, size + LARGE_PAGE_SIZE);
+	return 0;
+}
+
+static uint64_t nextRandom(void) {
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return seed;
+}
+
+static uint64_t now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+/**
+ * @brief Cuanta memoria anonima del proceso esta respaldada por paginas grandes, para confirmar que se usaron
+ */
+static uint64_t hugePagesKb(void) {
+	FILE *smaps = fopen("/proc/self/smaps_rollup", "r");
+	if (smaps == NULL) {
+		return 0;
+	}
+	char line[256];
+	unsigned long kb = 0;
+	while (fgets(line, sizeof(line), smaps) != NULL) {
+		if (sscanf(line, "AnonHugePages: %lu kB", &kb) == 1) {
+			break;
+		}
+	}
+	fclose(smaps);
+	return kb;
+}
@@ -3,6 +3,8 @@
 
 #include "include/color.h"
 #include "include/memory.h"
+#include "include/process.h"
+#include "include/scheduler.h"
 #include "include/video.h"
 #include <stdint.h>
 
@@ -37,6 +39,16 @@ void exceptionDispatcher(int ex, uint64_t *rip, uint64_t *rsp) {
 	printError(msg, *rip, rsp);
 }
 
+/**
+ * @brief Intenta resolver un page fault mapeando la pagina que falta
+ * @param address: Direccion que se quiso acceder (CR2)
+ * @param errorCode: Codigo de error que dejo el CPU
+ * @return 0 si se mapeo y hay que reintentar la instruccion, -1 si es un error del proceso
+ */
+int64_t pageFaultDispatcher(uint64_t address, uint64_t errorCode) {
+	return handleProcessPageFault(getCurrentProcess(), address, errorCode);
+}
+
 static void printError(char *msg, uint64_t rip, uint64_t *rsp) {
 	setFontColor(ERROR_COLOR);
 	printf("Error: %s\n\n", msg);
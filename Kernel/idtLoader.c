@@ -4,8 +4,16 @@
 #include "include/idtLoader.h"
 #include "include/defs.h"
 #include "include/interrupts.h"
+#include "include/lib.h"
 #include <stdint.h>
 
+#define KERNEL_CODE_DESCRIPTOR 0x00209A0000000000ULL /* Codigo de 64 bits, presente, nivel 0 */
+#define KERNEL_DATA_DESCRIPTOR 0x0000920000000000ULL /* Datos, presente, nivel 0 */
+#define TSS_SELECTOR 0x18
+#define TSS_AVAILABLE 0x89 /* TSS de 64 bits disponible, presente */
+#define FAULT_STACK_SIZE (4 * 4096)
+#define PAGE_FAULT_IST 1
+
 #pragma pack(push) /* Push de la alineación actual */
 #pragma pack(1)	   /* Alinear las siguiente estructuras a 1 byte */
 
@@ -17,17 +25,46 @@ typedef struct {
 	uint32_t offset_h, other_cero;
 } DESCR_INT;
 
+/* Task State Segment: en long mode solo sirve para elegir stacks, en este caso el de los page faults */
+typedef struct {
+	uint32_t reserved0;
+	uint64_t rsp[3];
+	uint64_t reserved1;
+	uint64_t ist[7];
+	uint64_t reserved2;
+	uint16_t reserved3;
+	uint16_t ioMapBase;
+} TSS;
+
+typedef struct {
+	uint16_t limit;
+	uint64_t base;
+} GDTR;
+
 #pragma pack(pop) /* Reestablece la alinceación actual */
 
 DESCR_INT *idt = (DESCR_INT *) 0; // IDT de 255 entradas
 
+/*
+ * Un page fault puede deberse a que el stack del proceso crecio hacia una pagina sin mapear. Si el CPU apilara el
+ * frame de la excepcion en ese mismo stack volveria a fallar, asi que el handler corre en un stack propio.
+ */
+static TSS tss;
+static uint64_t gdt[5];
+static uint8_t faultStack[FAULT_STACK_SIZE] __attribute__((aligned(16)));
+
 static void setup_IDT_entry(int index, uint64_t offset);
+static void setup_IDT_stack(int index, uint8_t ist);
+static void load_tss();
 
 void load_idt() {
+	load_tss();
+
 	setup_IDT_entry(0x00, (uint64_t) &_ex00Handler);
 	setup_IDT_entry(0x06, (uint64_t) &_ex06Handler);
 	setup_IDT_entry(0x0D, (uint64_t) &_ex0DHandler);
 	setup_IDT_entry(0x0E, (uint64_t) &_ex0EHandler);
+	setup_IDT_stack(0x0E, PAGE_FAULT_IST);
 
 	setup_IDT_entry(0x20, (uint64_t) &_irq00Handler);
 	setup_IDT_entry(0x21, (uint64_t) &_irq01Handler);
@@ -49,3 +86,31 @@ static void setup_IDT_entry(int index, uint64_t offset) {
 	idt[index].cero = 0;
 	idt[index].other_cero = (uint64_t) 0;
 }
+
+/* Los 3 bits bajos del byte que sigue al selector indican que stack de la TSS usar (0 es el actual) */
+static void setup_IDT_stack(int index, uint8_t ist) {
+	idt[index].cero = ist;
+}
+
+/**
+ * @brief Reemplaza la GDT de Pure64 por una con los mismos selectores de codigo y datos mas la TSS, y la carga
+ * @note  Se reescribe el descriptor en cada llamada: 'ltr' falla si la TSS ya figura como ocupada
+ */
+static void load_tss() {
+	uint64_t base = (uint64_t) &tss;
+	uint64_t limit = sizeof(TSS) - 1;
+
+	tss.ist[PAGE_FAULT_IST - 1] = (uint64_t) faultStack + FAULT_STACK_SIZE;
+	tss.ioMapBase = sizeof(TSS);
+
+	gdt[0] = 0;
+	gdt[1] = KERNEL_CODE_DESCRIPTOR;
+	gdt[2] = KERNEL_DATA_DESCRIPTOR;
+	gdt[3] = (limit & 0xFFFF) | ((base & 0xFFFFFF) << 16) | ((uint64_t) TSS_AVAILABLE << 40) |
+			 (((limit >> 16) & 0xF) << 48) | (((base >> 24) & 0xFF) << 56);
+	gdt[4] = base >> 32;
+
+	GDTR gdtr = {sizeof(gdt) - 1, (uint64_t) gdt};
+	_loadGdt(&gdtr);
+	_loadTr(TSS_SELECTOR);
+}
@@ -1,6 +1,8 @@
 #ifndef _KEYBOARD_H_
 #define _KEYBOARD_H_
 
+#include "waitQueue.h"
+
 #define KEYBOARD_SEM_ID 0 /* ID del semáforo para sincronización de I/O del teclado */
 
 /* Inicializa el driver del teclado (crea el semáforo de I/O) */
@@ -15,4 +17,10 @@ char getAscii();
 /* Devuelve el scancode del ultimo caracter en el buffer de teclado */
 char getScancode();
 
+/* Devuelve cuantas teclas quedan en el buffer; getAscii no bloquea mientras sea mayor a 0 */
+int pendingKeys();
+
+/* Cola de los procesos que esperan en poll a que llegue una tecla; se despierta con cada tecla nueva */
+waitQueueADT keyboardPollers();
+
 #endif
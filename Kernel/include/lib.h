@@ -1,24 +1,9 @@
 #ifndef _LIB_H
 #define _LIB_H
 
+#include "../../Shared/memops.h"
 #include <stdint.h>
 
-/**
- * @brief  Escribe 'character' en una direccion de memoria 'length' veces
- * @param  destination: Lugar a escribir
- * @param  character: Elemento a copiar
- * @param  length: Cantidad de veces que se desea escrbir el valor
- */
-void *memset(void *destination, int32_t character, uint64_t length);
-
-/**
- * @brief Copia a 'destination' 'length' caracteres de source
- * @param  destination: Direccion de origen
- * @param  source: Fuente
- * @param  length: Cantidad de bytes a copiar
- */
-void *memcpy(void *destination, const void *source, uint64_t length);
-
 /**
  * @brief Convierte un entero a string
  * @note  Actualmente no trabaja con negativos
@@ -111,6 +96,45 @@ int my_strcpy(char *dest, const char *origin);
  */
 int my_strlen(const char *s);
 
+/**
+ * @brief Lee el contador de ciclos del procesador
+ * @return Ciclos transcurridos desde el reset
+ */
+uint64_t _rdtsc();
+
+/**
+ * @brief Devuelve la direccion fisica de la PML4 activa
+ */
+uint64_t _readCR3();
+
+/**
+ * @brief Activa otra PML4; invalida todas las traducciones cacheadas en la TLB
+ * @param pageTable: Direccion fisica de la PML4
+ */
+void _writeCR3(uint64_t pageTable);
+
+/**
+ * @brief Invalida la traduccion cacheada de una pagina
+ * @param address: Direccion virtual dentro de la pagina
+ */
+void _invlpg(uint64_t address);
+
+/**
+ * @brief Activa CR0.WP para que el kernel tambien respete las paginas de solo lectura
+ */
+void _enableWriteProtect();
+
+/**
+ * @brief Carga la GDT
+ * @param gdtr: Puntero al descriptor de 10 bytes (limite y base)
+ */
+void _loadGdt(void *gdtr);
+
+/**
+ * @brief Carga el task register con el selector de la TSS
+ */
+void _loadTr(uint16_t selector);
+
 extern void callTimerTick();
 
 #endif
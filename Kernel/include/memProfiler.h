@@ -0,0 +1,52 @@
+#ifndef _MEM_PROFILER_H
+#define _MEM_PROFILER_H
+
+#include <stdint.h>
+
+#define MM_PROFILE_RATE 16	 // Se registra una de cada MM_PROFILE_RATE asignaciones
+#define MM_PROFILE_SAMPLES 1024 // Muestras vivas que se pueden seguir a la vez
+
+/**
+ * Sitio de asignacion: quien llamo a mm_alloc y desde que proceso, con lo que sigue vivo de lo que pidio.
+ */
+typedef struct memProfileSite {
+	uint64_t caller;
+	int64_t pid;
+	uint64_t liveBytes; // estimado: bytes de las muestras vivas multiplicados por MM_PROFILE_RATE
+	uint64_t samples;
+} memProfileSite_t;
+
+/*
+ * Los managers registran cada asignacion y liberacion con estas macros. Si el kernel se compila sin MM_PROFILE
+ * se expanden a nada y mm_alloc/mm_free no pagan ningun costo.
+ */
+#ifdef MM_PROFILE
+#define MM_PROFILE_ALLOC(ptr, size) memProfilerAlloc((ptr), (size), __builtin_return_address(0))
+#define MM_PROFILE_FREE(ptr) memProfilerFree(ptr)
+
+/**
+ * @brief Cuenta una asignacion y, si le toca ser muestreada, la registra
+ * @param ptr: Bloque devuelto por mm_alloc
+ * @param size: Bytes pedidos
+ * @param caller: Direccion de retorno de quien llamo a mm_alloc
+ */
+void memProfilerAlloc(void *ptr, uint64_t size, void *caller);
+
+/**
+ * @brief Descarta la muestra del bloque liberado, si la habia
+ */
+void memProfilerFree(void *ptr);
+#else
+#define MM_PROFILE_ALLOC(ptr, size) ((void) 0)
+#define MM_PROFILE_FREE(ptr) ((void) 0)
+#endif
+
+/**
+ * @brief Agrupa las muestras vivas por sitio y devuelve los que mas memoria retienen
+ * @param sites: Arreglo donde se escriben los sitios, ordenados de mayor a menor por bytes vivos
+ * @param max: Capacidad del arreglo
+ * @return Cantidad de sitios escritos, o -1 si el kernel se compilo sin MM_PROFILE
+ */
+int64_t memProfilerTopSites(memProfileSite_t *sites, uint32_t max);
+
+#endif
@@ -4,8 +4,10 @@
 #include <stddef.h>
 #include <stdint.h>
 
-#define HEAP_SIZE (256 * 1024 * 1024)
+#define HEAP_SIZE (256 * 1024 * 1024) // Tamaño usado si el BIOS no informa un mapa de memoria
 #define POW2(x) ((uint64_t) 1 << (x))
+#define MM_STATS_BUCKETS 32
+#define MM_MAX_ALLOC POW2(17) // pedido mas grande que aceptan los dos managers
 
 /**
  * Información general del estado del heap.
@@ -16,6 +18,24 @@ typedef struct mem {
 	uint64_t free;
 } mem_t;
 
+/**
+ * Estadisticas detalladas del heap, para distinguir fragmentacion de falta real de memoria.
+ */
+typedef struct mm_stats {
+	uint64_t size;
+	uint64_t used;
+	uint64_t free;
+	uint64_t peakUsed;					   // maximo de bytes otorgados en uso a la vez
+	uint64_t requestedBytes;			   // bytes pedidos acumulados desde el arranque
+	uint64_t grantedBytes;				   // bytes otorgados acumulados (con el redondeo de cada manager)
+	uint64_t largestFreeBlock;			   // bloque contiguo libre mas grande, en bytes
+	uint64_t allocCount;
+	uint64_t freeCount;
+	uint64_t failedCount;
+	uint64_t initCycles;				   // ciclos que tardo mm_create en el arranque
+	uint64_t freeBlocks[MM_STATS_BUCKETS]; // bloques libres con tamaño en [2^i, 2^(i+1)) bytes
+} mm_stats_t;
+
 typedef struct MemoryManagerCDT *MemoryManagerADT;
 
 /**
@@ -30,8 +50,8 @@ MemoryManagerADT mm_create(void *const restrict startAddress, uint64_t totalSize
 /**
  * @brief Reserva memoria dinámica dentro del heap administrado
  *
- * @param size Cantidad de bytes a reservar
- * @return void* Puntero al bloque asignado, o NULL si no hay espacio
+ * @param size Cantidad de bytes a reservar, hasta MM_MAX_ALLOC
+ * @return void* Puntero al bloque asignado, o NULL si no hay espacio o el pedido es mas grande que MM_MAX_ALLOC
  */
 void *mm_alloc(size_t size);
 
@@ -49,4 +69,12 @@ void mm_free(void *const restrict ptr);
  */
 mem_t mm_info(void);
 
+/**
+ * @brief Obtiene estadisticas detalladas del heap administrado
+ * @note  Recorre los metadatos del manager, no es una operacion O(1)
+ *
+ * @param stats Estructura donde se escriben las estadisticas
+ */
+void mm_stats(mm_stats_t *stats);
+
 #endif /* MEMORY_MANAGER_H */
\ No newline at end of file
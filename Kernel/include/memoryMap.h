@@ -0,0 +1,23 @@
+#ifndef _MEMORYMAP_H
+#define _MEMORYMAP_H
+
+#include <stdint.h>
+
+/**
+ * Region de memoria fisica contigua.
+ */
+typedef struct memoryRegion {
+	uint64_t start;
+	uint64_t size;
+} memoryRegion_t;
+
+/**
+ * @brief Busca la region de RAM utilizable mas grande segun el mapa E820 que arma Pure64
+ * @note  La region se recorta para empezar en 'minAddress' y terminar dentro de lo que Pure64 mapea.
+ *        Si el BIOS no informo un mapa la region devuelta tiene tamaño 0
+ * @param  minAddress: Direccion minima que puede ocupar la region
+ * @return Region encontrada
+ */
+memoryRegion_t getLargestUsableRegion(uint64_t minAddress);
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef _MEMORY_PRESSURE_H
+#define _MEMORY_PRESSURE_H
+
+#include <stdint.h>
+
+#define MM_RESERVE_SIZE (16 * 1024) // Heap que se guarda para las asignaciones criticas cuando no queda otra cosa
+#define MM_LOW_WATER (64 * 1024)	  // Libre que tiene que quedar ademas del pedido para que una falla sea fragmentacion
+
+/*
+ * Cuando no encuentran lugar, los managers le piden al kernel que libere memoria y reintentan mientras
+ * MM_RECLAIM devuelva distinto de 0. El benchmark de los managers corre en el host sin el resto del kernel y
+ * se compila con MM_BENCH, asi que ahi un pedido que falla falla directamente.
+ */
+#ifndef MM_BENCH
+#define MM_RECLAIM(size) memoryPressureReclaim(size)
+#else
+#define MM_RECLAIM(size) 0
+#endif
+
+/**
+ * @brief Aparta la reserva para asignaciones criticas
+ * @note  Se llama una sola vez, justo despues de crear el memory manager
+ */
+void initMemoryPressure();
+
+/**
+ * @brief Intenta liberar memoria despues de que un pedido al heap fallo
+ * @note  Primero vacia lo que el kernel retiene sin necesitarlo. Si no alcanza, una asignacion critica recibe la
+ *        reserva y cualquier otra, si de verdad no queda memoria (lo libre no llega al pedido mas MM_LOW_WATER),
+ *        deja pedido que se mate al proceso con mas memoria en el proximo tick: matarlo aca romperia los recorridos
+ *        de listas de quien esta pidiendo memoria. Si sobra memoria pero esta partida, el pedido solo falla
+ * @param size: Bytes del pedido que fallo
+ * @return 1 si se libero algo y vale la pena reintentar, 0 si no
+ */
+int memoryPressureReclaim(uint64_t size);
+
+/**
+ * @brief Marca el comienzo de asignaciones que no pueden fallar, como los nodos de las colas del scheduler
+ * @note  Se pueden anidar; cada llamada se cierra con endCriticalAllocation
+ */
+void beginCriticalAllocation();
+
+/**
+ * @brief Cierra un tramo abierto con beginCriticalAllocation
+ */
+void endCriticalAllocation();
+
+/**
+ * @brief Mata al proceso elegido si algun pedido quedo sin memoria desde el ultimo tick
+ * @note  Se llama desde schedule, donde ninguna lista se esta recorriendo
+ */
+void handleMemoryPressure();
+
+/**
+ * @brief Vuelve a apartar la reserva si se habia usado
+ * @note  Se llama cada vez que muere un proceso, que es cuando vuelve memoria al heap. Si no hay lugar todavia no
+ *        cuenta como falta de memoria
+ */
+void refillMemoryReserve();
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef MESSAGE_QUEUE_H
+#define MESSAGE_QUEUE_H
+
+#include "waitQueue.h"
+#include <stdint.h>
+
+#define MQ_NAME_LENGTH 32		// incluye el '\0'
+#define MQ_MAX_DEPTH 64			// lo mas que se le puede pedir a una cola
+#define MQ_MAX_MESSAGE 1024		// tamaño maximo de un mensaje
+#define MQ_PRIORITIES 8			// prioridades de 0 (la mas baja) a MQ_PRIORITIES - 1
+#define MQ_TABLE_INITIAL_SIZE 8
+#define MQ_MAX_ID INT16_MAX
+
+/*
+ * Colas de mensajes con nombre. A diferencia de un pipe no mezclan los bytes de distintos envios: cada mqSend deja un
+ * mensaje entero y cada mqReceive se lleva uno entero, el de mayor prioridad y, entre los de igual prioridad, el mas
+ * viejo. Los lugares para los mensajes se reservan al crear la cola (profundidad x tamaño maximo), asi que enviar no
+ * pide memoria. Como los FIFOs, la cola se crea con la primera apertura y se libera cuando se cierra la ultima.
+ */
+typedef struct {
+	int16_t next; // siguiente mensaje de la misma prioridad, o siguiente lugar libre; -1 al final
+	uint16_t length;
+} mqSlot_t;
+
+typedef struct {
+	char name[MQ_NAME_LENGTH];
+	int depth;	 // cantidad de lugares
+	int maxSize; // bytes de cada lugar
+	int count;	 // mensajes encolados
+	int refs;	 // aperturas sin cerrar
+	mqSlot_t *slots;
+	char *data; // depth lugares de maxSize bytes
+	int16_t head[MQ_PRIORITIES];
+	int16_t tail[MQ_PRIORITIES];
+	int16_t freeSlots;
+	waitQueueADT receivers; // esperando un mensaje
+	waitQueueADT senders;	// esperando un lugar
+	uint8_t lock;
+} mqueue_t;
+
+/**
+ * @brief Inicializa la tabla de colas de mensajes
+ */
+void initializeMessageQueues();
+
+/**
+ * @brief Abre una cola por nombre, creandola si todavia no existe
+ * @note  'depth' y 'maxSize' solo se usan al crearla; quien abre una existente recibe la que ya hay
+ * @param name Nombre de la cola, de 1 a MQ_NAME_LENGTH - 1 caracteres
+ * @param depth Mensajes que entran antes de que mqSend bloquee, de 1 a MQ_MAX_DEPTH
+ * @param maxSize Tamaño maximo de cada mensaje, de 1 a MQ_MAX_MESSAGE
+ * @return ID de la cola, o -1 si algun parametro es invalido o no hay memoria
+ */
+int mqOpen(const char *name, int depth, int maxSize);
+
+/**
+ * @brief Suma una apertura a una cola que ya existe, como cuando un proceso la hereda con fork
+ * @param id ID de la cola
+ * @return 0 en caso de éxito, -1 si la cola no existe
+ */
+int mqRetain(int id);
+
+/**
+ * @brief Suelta una apertura; con la ultima la cola se libera junto con los mensajes que tenia
+ * @param id ID de la cola
+ * @return 0 en caso de éxito, -1 si la cola no existe
+ */
+int mqClose(int id);
+
+/**
+ * @brief Saca a un proceso que muere de las colas de espera de una cola de mensajes
+ * @param id ID de la cola
+ * @param pid Proceso que muere
+ */
+void mqCancel(int id, int16_t pid);
+
+/**
+ * @brief Encola un mensaje entero
+ * @note  Bloquea mientras la cola este llena
+ * @param id ID de la cola
+ * @param message Contenido del mensaje
+ * @param length Tamaño del mensaje, hasta el maximo de la cola (puede ser 0)
+ * @param priority Prioridad, de 0 a MQ_PRIORITIES - 1
+ * @return 0 en caso de éxito, o -1 si los parametros son invalidos o la cola dejo de existir
+ */
+int mqSend(int id, const char *message, int length, int priority);
+
+/**
+ * @brief Saca el mensaje de mayor prioridad; entre los de igual prioridad, el mas viejo
+ * @note  Bloquea mientras la cola este vacia. Si el mensaje no entra en 'size' queda en la cola
+ * @param id ID de la cola
+ * @param buffer Donde se copia el mensaje
+ * @param size Capacidad del buffer
+ * @param priority Donde se deja la prioridad del mensaje, o NULL
+ * @return Tamaño del mensaje, o -1 si el buffer es chico, los parametros son invalidos o la cola dejo de existir
+ */
+int mqReceive(int id, char *buffer, int size, int *priority);
+
+#endif
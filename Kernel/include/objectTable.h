@@ -0,0 +1,62 @@
+#ifndef OBJECT_TABLE_H
+#define OBJECT_TABLE_H
+
+#include "waitQueue.h"
+#include <stdint.h>
+
+/*
+ * Tabla de punteros que indexa objetos del kernel por id, como los pipes y las colas de mensajes. Arranca vacia y se
+ * duplica cuando se llena, hasta un maximo. Cada lugar guarda ademas un numero de serie que cambia con cada objeto
+ * que lo ocupa, para que quien durmio esperando a un objeto pueda saber al despertar si sigue siendo el mismo o si
+ * se libero y su id quedo para otro.
+ */
+typedef struct {
+	void *object; // NULL si el lugar esta libre
+	uint32_t serial;
+} tableSlot_t;
+
+typedef struct {
+	tableSlot_t *slots;
+	int size;
+	int initialSize; // lugares con los que se crea la primera vez
+	int maxSize;
+	uint32_t nextSerial;
+} objectTable_t;
+
+/**
+ * @brief Deja la tabla vacia; la memoria se pide con el primer objeto
+ * @param table Tabla a inicializar
+ * @param initialSize Lugares que se reservan la primera vez
+ * @param maxSize Lugares que puede llegar a tener
+ */
+void initializeObjectTable(objectTable_t *table, int initialSize, int maxSize);
+
+/**
+ * @brief Busca el objeto de un lugar
+ * @return El objeto, o NULL si el indice esta fuera de la tabla o el lugar esta libre
+ */
+void *objectTableGet(objectTable_t *table, int index);
+
+/**
+ * @brief Guarda un objeto en el primer lugar libre, agrandando la tabla si hace falta
+ * @return Indice donde quedo, o -1 si no hay memoria o la tabla ya tiene maxSize lugares ocupados
+ */
+int objectTableAdd(objectTable_t *table, void *object);
+
+/**
+ * @brief Libera un lugar; el objeto lo libera quien lo creo
+ */
+void objectTableRemove(objectTable_t *table, int index);
+
+/**
+ * @brief Bloquea al proceso actual en una cola de espera del objeto de un lugar, con el lock del objeto tomado
+ * @note  Al despertar el objeto se vuelve a buscar por indice y numero de serie, porque mientras dormia pudo liberarse
+ * @param table Tabla donde esta el objeto
+ * @param index Lugar del objeto
+ * @param queue Cola de espera del objeto
+ * @param lock Lock del objeto, tomado
+ * @return El objeto con el lock tomado, o NULL si ya no existe o no se pudo encolar (en ese caso sin el lock)
+ */
+void *objectTableSleep(objectTable_t *table, int index, waitQueueADT queue, uint8_t *lock);
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef _PAGING_H
+#define _PAGING_H
+
+#include <stdint.h>
+
+#define PAGE_SIZE 0x1000
+#define PAGE_MASK (PAGE_SIZE - 1)
+
+/* Bits del codigo de error que el CPU deja en un page fault */
+#define PAGE_FAULT_PRESENT 0x1 // la pagina estaba mapeada: es una violacion de permisos, no una pagina ausente
+#define PAGE_FAULT_WRITE 0x2   // el acceso era una escritura
+
+/**
+ * @brief Arma las tablas de paginas del kernel y las activa
+ * @note  Los marcos para tablas y paginas de procesos salen de un pool propio, distinto del heap. El kernel se
+ *        mapea por identidad desde 0 hasta 'identityEnd', mas el framebuffer: lo que esta por debajo del heap con
+ *        paginas de 4 KiB, y el heap, el pool y el framebuffer con paginas de 2 MiB donde estan alineados
+ * @param  poolStart: Comienzo del pool de marcos
+ * @param  poolSize: Tamaño del pool de marcos
+ * @param  heapStart: Comienzo del heap del kernel
+ * @param  identityEnd: Fin de la memoria fisica que el kernel necesita ver
+ * @return 0 si se pudo, -1 si el pool no alcanza
+ */
+int initPaging(uint64_t poolStart, uint64_t poolSize, uint64_t heapStart, uint64_t identityEnd);
+
+/**
+ * @brief Devuelve la PML4 del kernel, la que se usa cuando no corre ningun proceso
+ */
+uint64_t getKernelPageTable();
+
+/**
+ * @brief Crea un espacio de direcciones nuevo que comparte el mapa del kernel y no tiene nada propio mapeado
+ * @return Direccion fisica de su PML4, o 0 si no hay marcos
+ */
+uint64_t createAddressSpace();
+
+/**
+ * @brief Libera las tablas y todas las paginas propias de un espacio de direcciones
+ * @note  Puede llamarse con el espacio activo: los marcos solo se apilan y nadie los reusa hasta el proximo cambio
+ * @param  pageTable: PML4 devuelta por createAddressSpace
+ */
+void destroyAddressSpace(uint64_t pageTable);
+
+/**
+ * @brief Mapea un marco nuevo, lleno de ceros, en una direccion virtual de un espacio de direcciones
+ * @param  pageTable: PML4 del espacio de direcciones
+ * @param  virtualAddress: Direccion alineada a pagina
+ * @return Direccion fisica del marco, o 0 si no hay marcos o la pagina ya estaba mapeada
+ */
+uint64_t mapNewPage(uint64_t pageTable, uint64_t virtualAddress);
+
+/**
+ * @brief Duplica un espacio de direcciones copy-on-write
+ * @note  Solo se copian las tablas: las paginas propias pasan a estar compartidas, de solo lectura, en los dos espacios
+ *        y cada una se copia recien cuando alguno de los dos la escribe
+ * @param  pageTable: PML4 del espacio a duplicar
+ * @return PML4 de la copia, o 0 si no hay marcos
+ */
+uint64_t cloneAddressSpace(uint64_t pageTable);
+
+/**
+ * @brief Deja una pagina escribible en un espacio de direcciones, copiandola si esta compartida por un fork
+ * @param  pageTable: PML4 del espacio de direcciones
+ * @param  virtualAddress: Direccion dentro de la pagina
+ * @param  copied: Donde se deja 1 si hizo falta un marco nuevo para la copia y 0 si no, o NULL
+ * @return Direccion fisica del marco que quedo mapeado, o 0 si la pagina no esta mapeada, es de solo lectura o no hay
+ *         marcos para la copia
+ */
+uint64_t makePageWritable(uint64_t pageTable, uint64_t virtualAddress, int *copied);
+
+/**
+ * @brief Desmapea una pagina y suelta su marco
+ * @param  pageTable: PML4 del espacio de direcciones
+ * @param  virtualAddress: Direccion alineada a pagina
+ * @return 0 si la pagina estaba mapeada, -1 si no
+ */
+int unmapPage(uint64_t pageTable, uint64_t virtualAddress);
+
+#endif
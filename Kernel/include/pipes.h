@@ -1,28 +1,50 @@
 #ifndef PIPES_H
 #define PIPES_H
 
-#include "semaphore.h"
+#include "process.h"
+#include "waitQueue.h"
+#include <stdint.h>
 
-#define MAX_PIPES 16
-#define PIPE_BUFFER_SIZE 512
+#define PIPE_DEFAULT_CAPACITY 512				 // capacidad con la que se crea cada pipe
+#define PIPE_CAPACITY_UNIT 0x1000				 // una pagina: las capacidades mayores se redondean a este multiplo
+#define PIPE_MAX_CAPACITY (16 * PIPE_CAPACITY_UNIT) // lo mas que se le puede pedir a setPipeCapacity
+#define PIPE_TABLE_INITIAL_SIZE 16
+#define PIPE_MAX_ID INT16_MAX // los ids se guardan en los descriptores de los procesos, que son de 16 bits
+#define PIPE_NAME_LENGTH 32	  // incluye el '\0'
 
+#define PIPE_READ_END 0
+#define PIPE_WRITE_END 1
+
+/*
+ * Los pipes se reservan del heap del kernel al crearlos y se liberan al cerrarlos, y la tabla que los indexa se
+ * duplica cuando se llena, asi que no hay un maximo fijo de pipes abiertos ni se gastan ids de semaforos.
+ * Cada extremo cuenta sus referencias: quien crea el pipe tiene una de cada uno y cada proceso que lo tiene como
+ * STDIN o como STDOUT/STDERR suma otra. Sin escritores los lectores reciben EOF despues de vaciar el buffer, sin
+ * lectores los escritores reciben -1, y sin ninguna de las dos el pipe se libera.
+ * Un pipe con nombre (FIFO) se crea con openNamedPipe la primera vez que alguien lo abre y no tiene creador. Hasta que
+ * un extremo tuvo su primera referencia el otro lado espera en vez de ver EOF o -1, asi que lectores y escritores
+ * pueden abrirlo en cualquier orden.
+ */
 typedef struct {
-	char buffer[PIPE_BUFFER_SIZE];
+	char *buffer;
+	int capacity;
 	int readIdx;
 	int writeIdx;
 	int count;
-	int semReaders;
-	int semWriters;
-	int mutex;
-	int readers;
-	int writers;
-	int isOpen;
+	int readers; // referencias al extremo de lectura
+	int writers; // referencias al extremo de escritura
+	int creatorOpen; // el creador todavia no llamo a closePipe
+	int16_t creator; // pid del creador, -1 en los pipes con nombre
+	uint8_t flags; // FD_NONBLOCK para quienes lo usan por id con sys_pipe_read/sys_pipe_write
+	uint8_t openedEnds; // extremos que alguna vez tuvieron referencias, un bit por PIPE_READ_END y PIPE_WRITE_END
+	char name[PIPE_NAME_LENGTH]; // vacio si el pipe es anonimo
+	waitQueueADT readersQueue; // lectores esperando datos
+	waitQueueADT writersQueue; // escritores esperando lugar
+	uint8_t lock;
 } pipe_t;
 
-typedef struct {
-	pipe_t pipes[MAX_PIPES]; // vector de pipes
-	int next_pipe_id;
-} pipeManager;
+/* Recibe un tramo contiguo del buffer de un pipe; consumePipe lo llama con el lock del pipe tomado */
+typedef void (*pipeConsumer)(const char *data, int length);
 
 /**
  * @brief Inicializa el gestor de pipes del sistema
@@ -30,33 +52,143 @@ typedef struct {
 void initializePipeManager();
 
 /**
- * @brief Crea un nuevo pipe
- * @return ID del pipe creado o -1 en caso de error
+ * @brief Crea un nuevo pipe con capacidad PIPE_DEFAULT_CAPACITY
+ * @param creator Proceso que lo crea y se queda con una referencia de cada extremo hasta llamar a closePipe
+ * @return ID del pipe creado o -1 si no hay memoria
+ */
+int createPipe(int16_t creator);
+
+/**
+ * @brief Abre un extremo de un pipe con nombre, creandolo si todavia no existe
+ * @note  Suma una referencia al extremo pedido; se suelta con closePipeEnd. El nombre deja de existir cuando el pipe
+ *        se queda sin referencias
+ * @param name Nombre del pipe, de 1 a PIPE_NAME_LENGTH - 1 caracteres
+ * @param end PIPE_READ_END o PIPE_WRITE_END
+ * @return ID del pipe, o -1 si el nombre o el extremo son invalidos o no hay memoria
+ */
+int openNamedPipe(const char *name, int end);
+
+/**
+ * @brief Cambia la capacidad del buffer de un pipe
+ * @note  Pedidos mayores a PIPE_DEFAULT_CAPACITY se redondean hacia arriba a un multiplo de PIPE_CAPACITY_UNIT. Los
+ *        datos que ya estaban en el pipe se conservan
+ * @param pipe_id ID del pipe
+ * @param capacity Capacidad pedida en bytes, hasta PIPE_MAX_CAPACITY
+ * @return Capacidad resultante, o -1 si el pedido es invalido, no alcanza para lo que ya hay o no hay memoria
+ */
+int setPipeCapacity(int pipe_id, int capacity);
+
+/**
+ * @brief Mueve hasta 'size' bytes de un pipe a otro sin copiarlos a ningun buffer intermedio
+ * @note  Bloquea hasta que el origen tenga datos y el destino tenga lugar, y mueve lo que entre de una vez
+ * @param in_id ID del pipe de origen
+ * @param out_id ID del pipe de destino, distinto del origen
+ * @param size Maximo de bytes a mover
+ * @param nonBlocking Si es distinto de 0, en vez de bloquear devuelve WOULD_BLOCK
+ * @return Bytes movidos, 0 si el origen llego a EOF, WOULD_BLOCK, o -1 si el destino no tiene lectores o algun pipe no
+ *         existe
+ */
+int splicePipe(int in_id, int out_id, int size, int nonBlocking);
+
+/**
+ * @brief Entrega a 'consumer' hasta 'size' bytes de un pipe directamente desde su buffer
+ * @note  Bloquea solo si el pipe esta vacio y todavia tiene escritores. Los datos llegan en uno o dos tramos
+ * @param pipe_id ID del pipe
+ * @param size Maximo de bytes a consumir
+ * @param consumer Funcion que recibe los tramos
+ * @param nonBlocking Si es distinto de 0, con el pipe vacio devuelve WOULD_BLOCK en vez de bloquear
+ * @return Bytes consumidos, 0 si el pipe llego a EOF, WOULD_BLOCK, o -1 en caso de error
  */
-int createPipe();
+int consumePipe(int pipe_id, int size, pipeConsumer consumer, int nonBlocking);
+
+/**
+ * @brief Consulta sin bloquear en que estado esta un pipe
+ * @param pipe_id ID del pipe
+ * @return Combinacion de POLLIN, POLLOUT, POLLHUP y POLLERR (ver poll.h), o POLLNVAL si el pipe no existe
+ */
+int pipeEvents(int pipe_id);
+
+/**
+ * @brief Anota a un proceso en las colas del pipe sin bloquearlo, para que lo despierte el proximo cambio
+ * @note  Con POLLIN espera datos o que se vayan los escritores, con POLLOUT lugar o que se vayan los lectores
+ * @param pipe_id ID del pipe
+ * @param events POLLIN y/o POLLOUT
+ * @param pid Proceso a anotar
+ * @return 0 en caso de éxito, -1 si el pipe no existe o no hay memoria (sin quedar anotado)
+ */
+int watchPipe(int pipe_id, int events, int16_t pid);
+
+/**
+ * @brief Deshace watchPipe; no hace nada si el pipe ya no existe o el proceso ya fue despertado
+ * @param pipe_id ID del pipe
+ * @param events Los mismos eventos que se pasaron a watchPipe
+ * @param pid Proceso anotado
+ */
+void unwatchPipe(int pipe_id, int events, int16_t pid);
+
+/**
+ * @brief Suma una referencia a un extremo del pipe
+ * @param pipe_id ID del pipe
+ * @param end PIPE_READ_END o PIPE_WRITE_END
+ * @return 0 en caso de éxito, -1 si el pipe no existe
+ */
+int openPipeEnd(int pipe_id, int end);
+
+/**
+ * @brief Suelta una referencia a un extremo del pipe
+ * @note  Con el ultimo escritor se despierta a los lectores para que vean EOF, y con el ultimo lector a los
+ *        escritores para que fallen
+ * @param pipe_id ID del pipe
+ * @param end PIPE_READ_END o PIPE_WRITE_END
+ * @return 0 en caso de éxito, -1 si el pipe no existe
+ */
+int closePipeEnd(int pipe_id, int end);
 
 /**
  * @brief Lee datos de un pipe
+ * @note  Bloquea solo si el pipe esta vacio y todavia tiene escritores; si hay datos devuelve los que haya, hasta
+ *        'size'
  * @param pipe_id ID del pipe del cual leer
  * @param buffer Buffer donde se almacenarán los datos leídos
  * @param size Cantidad de bytes a leer
- * @return Cantidad de bytes leídos o -1 en caso de error
+ * @param nonBlocking Si es distinto de 0, en vez de bloquear devuelve WOULD_BLOCK
+ * @return Cantidad de bytes leídos, WOULD_BLOCK, o -1 en EOF o en caso de error
  */
-int readPipe(int pipe_id, char *buffer, int size);
+int readPipe(int pipe_id, char *buffer, int size, int nonBlocking);
 
 /**
  * @brief Escribe datos en un pipe
+ * @note  Copia de a tramos lo que entra en el buffer y bloquea solo cuando esta lleno, hasta escribir todo o hasta
+ *        que no queden lectores
  * @param pipe_id ID del pipe en el cual escribir
  * @param buffer Buffer con los datos a escribir
  * @param size Cantidad de bytes a escribir
- * @return Cantidad de bytes escritos o -1 en caso de error
+ * @param nonBlocking Si es distinto de 0, con el buffer lleno devuelve lo que ya escribio, o WOULD_BLOCK si no entro
+ *        nada
+ * @return Cantidad de bytes escritos, WOULD_BLOCK, o -1 si no quedan lectores o en caso de error
+ */
+int writePipe(int pipe_id, const char *buffer, int size, int nonBlocking);
+
+/**
+ * @brief Devuelve los flags que se le pusieron al pipe con setPipeFlags
+ * @param pipe_id ID del pipe
+ * @return Los flags, o -1 si el pipe no existe
  */
-int writePipe(int pipe_id, const char *buffer, int size);
+int getPipeFlags(int pipe_id);
 
 /**
- * @brief Cierra un pipe
+ * @brief Cambia los flags con los que se lee y escribe el pipe cuando se lo usa por id
+ * @note  Los comparten todos los procesos que usan ese id; los descriptores 0 a 2 tienen los suyos en el proceso
+ * @param pipe_id ID del pipe
+ * @param flags 0 o FD_NONBLOCK
+ * @return 0 en caso de éxito, -1 si el pipe no existe o los flags son invalidos
+ */
+int setPipeFlags(int pipe_id, int flags);
+
+/**
+ * @brief Suelta las referencias del creador del pipe, una de cada extremo
  * @param pipe_id ID del pipe a cerrar
- * @return 0 en caso de éxito, -1 en caso de error
+ * @return 0 en caso de éxito, -1 si el pipe no existe o ya se habia cerrado
  */
 int closePipe(int pipe_id);
 
@@ -67,4 +199,17 @@ int closePipe(int pipe_id);
  */
 int clearPipe(int pipe_id);
 
+/**
+ * @brief Saca a un proceso que muere de las colas de espera de todos los pipes
+ * @note  Si quedara anotado, la proxima lectura o escritura despertaria a otro proceso que haya recibido su pid
+ * @param pid Proceso que muere
+ */
+void pipeCancel(int16_t pid);
+
+/**
+ * @brief Suelta las referencias de creador que le quedaban a un proceso que muere sin haber llamado a closePipe
+ * @param pid Proceso que muere
+ */
+void closeCreatedPipes(int16_t pid);
+
 #endif
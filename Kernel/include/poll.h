@@ -0,0 +1,54 @@
+#ifndef POLL_H
+#define POLL_H
+
+#include <stdint.h>
+
+#define POLLIN 0x1	 // hay datos para leer, o el pipe llego a EOF
+#define POLLOUT 0x2	 // se puede escribir sin bloquear
+#define POLLHUP 0x4	 // el pipe ya no tiene escritores
+#define POLLERR 0x8	 // el pipe ya no tiene lectores
+#define POLLNVAL 0x10 // el descriptor no es un pipe ni una terminal
+
+#define POLL_MAX_FDS 16
+#define POLL_FOREVER (-1)
+
+/*
+ * Descriptor a vigilar. Los descriptores 0 a 2 se resuelven con los del proceso (STDIN es el teclado si no esta
+ * redirigido); desde 3 son ids de pipes, como en sys_pipe_read. Los negativos se ignoran. Debe coincidir con pollfd_t
+ * de Userland/SampleCodeModule/include/shared.h.
+ */
+typedef struct {
+	int16_t fd;
+	int16_t events;	 // POLLIN y/o POLLOUT
+	int16_t revents; // lo que esta listo; POLLHUP, POLLERR y POLLNVAL se informan aunque no se pidan
+} pollfd_t;
+
+/**
+ * @brief Inicializa la lista de procesos bloqueados en poll
+ */
+void initializePoll();
+
+/**
+ * @brief Espera a que alguno de los descriptores este listo
+ * @note  Se anota en las colas de espera de cada pipe (y en la del teclado) y se bloquea una sola vez; al despertar
+ *        vuelve a revisar todos. El timeout lo vence el timer con pollTick
+ * @param fds Descriptores a vigilar, hasta POLL_MAX_FDS
+ * @param nfds Cantidad de descriptores
+ * @param timeout Ticks del timer a esperar: 0 solo consulta, POLL_FOREVER espera sin limite
+ * @return Cantidad de descriptores con revents distinto de 0, 0 si vencio el timeout, o -1 en caso de error
+ */
+int pollFds(pollfd_t *fds, int nfds, int64_t timeout);
+
+/**
+ * @brief Despierta a los procesos cuyo timeout vencio
+ * @param now Ticks transcurridos desde el arranque
+ */
+void pollTick(uint64_t now);
+
+/**
+ * @brief Saca a un proceso que muere de las colas en las que esperaba
+ * @param pid Proceso que muere
+ */
+void pollCancel(int16_t pid);
+
+#endif
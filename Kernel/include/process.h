@@ -2,13 +2,35 @@
 #define PROCESS_H
 
 #include "doubleLinkedList.h"
+#include <stddef.h>
 #include <stdint.h>
 
 #define CANT_FILE_DESCRIPTORS 3
-#define STACK_SIZE 4096
+
+#define FD_NONBLOCK 0x1 // las lecturas y escrituras que tendrian que esperar devuelven WOULD_BLOCK
+#define WOULD_BLOCK (-2)
+
+#define MAX_OPEN_FIFOS 8 // pipes con nombre que un proceso puede tener abiertos a la vez
+#define MAX_OPEN_MQUEUES 8 // colas de mensajes que un proceso puede tener abiertas a la vez
+
+/*
+ * Region propia de cada proceso (entrada 1 de su PML4). Nada se mapea de antemano: cada pagina se entrega en cero
+ * la primera vez que se toca. Debe coincidir con Userland/SampleCodeModule/include/shared.h
+ */
+#define PROCESS_REGION_BASE 0x8000000000ULL
+#define PROCESS_LOCAL_BASE PROCESS_REGION_BASE					  // una pagina para datos propios del proceso
+#define PROCESS_STACK_TOP (PROCESS_REGION_BASE + 0x40000000ULL) // el stack crece hacia abajo desde aca
+#define PROCESS_HEAP_BASE (PROCESS_REGION_BASE + 0x80000000ULL) // el heap crece hacia arriba con sbrk
+#define PROCESS_HEAP_SIZE 0x40000000ULL
+#define STACK_SIZE (1024 * 1024) // tamaño maximo del stack; solo ocupa memoria lo que se usa
 
 typedef enum { READY, RUNNING, BLOCKED, TERMINATED } ProcessState;
 
+typedef struct {
+	int16_t id; // -1 si el lugar esta libre
+	int8_t end; // PIPE_READ_END o PIPE_WRITE_END
+} openFifo_t;
+
 typedef struct ProcessContext {
 	char *name;
 	uint8_t priority;
@@ -18,15 +40,25 @@ typedef struct ProcessContext {
 	uint64_t stackBase;
 	uint64_t stackPos;
 
+	uint64_t pageTable;		// PML4 del espacio de direcciones del proceso
+	uint64_t heapBreak;		// fin del heap propio, entre PROCESS_HEAP_BASE y PROCESS_HEAP_BASE + PROCESS_HEAP_SIZE
+	uint64_t residentPages; // marcos a su cuenta: los que mapeo y las copias de sus fallos copy-on-write
+
 	ProcessState status;
 	char ground; // 0 1
 
-	char **argv;
+	char **argv; // arriba del stack del proceso: solo es valido dentro de su espacio de direcciones
 	int argc;
 	uint64_t rip;
 	int16_t fileDescriptors[CANT_FILE_DESCRIPTORS];
+	uint8_t fdFlags[CANT_FILE_DESCRIPTORS]; // FD_NONBLOCK de cada descriptor
+	openFifo_t fifos[MAX_OPEN_FIFOS];		// extremos de pipes con nombre abiertos con sys_pipe_open
+	int16_t mqueues[MAX_OPEN_MQUEUES];		// colas de mensajes abiertas con sys_mq_open, -1 en los lugares libres
 
 	doubleLinkedListADT waitingList;
+
+	doubleLinkedListADT allocations; // bloques pedidos por el proceso con sys_mm_alloc
+	uint64_t memoryUsage;			 // bytes reservados por esos bloques
 } ProcessContext;
 
 /**
@@ -73,14 +105,131 @@ int changeFileDescriptors(int16_t pid, int16_t fileDescriptors[]);
  */
 int changePriority(int16_t pid, uint8_t priority);
 
+/**
+ * @brief Reserva memoria del heap a nombre de un proceso
+ * @note  El bloque queda registrado en el proceso y se libera automaticamente cuando este muere
+ * @param process Proceso dueño del bloque
+ * @param size Cantidad de bytes a reservar
+ * @return Puntero al bloque o NULL si no hay memoria
+ */
+void *processAlloc(ProcessContext *process, size_t size);
+
+/**
+ * @brief Libera un bloque si pertenece al proceso
+ * @param process Proceso en el que se busca el bloque
+ * @param ptr Bloque a liberar
+ * @return 0 si el bloque era del proceso y se libero, -1 si no le pertenece
+ */
+int processFree(ProcessContext *process, void *ptr);
+
+/**
+ * @brief Libera de una vez todos los bloques que pidio un proceso
+ * @param process Proceso cuyos bloques se liberan
+ */
+void freeProcessAllocations(ProcessContext *process);
+
+/**
+ * @brief Suma las referencias a los pipes que el proceso tiene como descriptores y a sus pipes con nombre
+ * @note  STDIN cuenta como lector y STDOUT/STDERR como escritores
+ * @param process Proceso ya inicializado
+ */
+void openProcessPipes(ProcessContext *process);
+
+/**
+ * @brief Abre un extremo de un pipe con nombre a cuenta del proceso
+ * @note  La referencia se suelta con closeProcessFifo o cuando el proceso muere, y la heredan sus hijos con fork
+ * @param process Proceso que lo abre
+ * @param name Nombre del pipe
+ * @param end PIPE_READ_END o PIPE_WRITE_END
+ * @return ID del pipe, o -1 si el proceso ya tiene MAX_OPEN_FIFOS abiertos o no se pudo abrir
+ */
+int openProcessFifo(ProcessContext *process, const char *name, int end);
+
+/**
+ * @brief Cierra un extremo que el proceso abrio con openProcessFifo
+ * @return 0 en caso de éxito, -1 si el proceso no tenia abierto ese extremo
+ */
+int closeProcessFifo(ProcessContext *process, int16_t pipeId, int end);
+
+/**
+ * @brief Suelta las referencias que sumo openProcessPipes, las de los pipes con nombre que abrio
+ * y las de creador de los pipes anonimos que creo y nunca cerro
+ * @param process Proceso que termina
+ */
+void closeProcessPipes(ProcessContext *process);
+
+/**
+ * @brief Abre una cola de mensajes a cuenta del proceso
+ * @note  Se cierra con closeProcessQueue o cuando el proceso muere, y la heredan sus hijos con fork
+ * @return ID de la cola, o -1 si el proceso ya tiene MAX_OPEN_MQUEUES abiertas o no se pudo abrir
+ */
+int openProcessQueue(ProcessContext *process, const char *name, int depth, int maxSize);
+
+/**
+ * @brief Cierra una cola que el proceso abrio con openProcessQueue
+ * @return 0 en caso de éxito, -1 si el proceso no la tenia abierta
+ */
+int closeProcessQueue(ProcessContext *process, int16_t id);
+
+/**
+ * @brief Indica si el proceso tiene abierta una cola; solo se puede enviar o recibir por las propias
+ * @return 1 si la tiene abierta, 0 si no
+ */
+int hasProcessQueue(ProcessContext *process, int16_t id);
+
+/**
+ * @brief Suma las aperturas de las colas de mensajes que un proceso hijo heredo
+ */
+void retainProcessQueues(ProcessContext *process);
+
+/**
+ * @brief Cierra todas las colas de mensajes que le quedaban abiertas a un proceso que termina
+ * @note  Antes lo saca de sus colas de espera, para que un envio o recepcion posterior no despierte a otro proceso
+ *        que haya recibido su pid
+ */
+void closeProcessQueues(ProcessContext *process);
+
+/**
+ * @brief Mueve el fin del heap propio del proceso
+ * @note  Agrandarlo no reserva memoria: las paginas se mapean al tocarlas. Achicarlo devuelve las que quedan afuera
+ * @param process Proceso dueño del heap
+ * @param increment Bytes a agregar (o quitar si es negativo)
+ * @return Fin anterior del heap, o NULL si se sale de la region del heap
+ */
+void *processSbrk(ProcessContext *process, int64_t increment);
+
+/**
+ * @brief Resuelve un page fault del proceso
+ * @note  Una pagina ausente se mapea en cero si cae en el stack, el heap o la pagina local. Escribir una pagina
+ *        compartida por un fork le da al proceso su propia copia. Cualquier otro caso es un error del proceso
+ * @param process Proceso que produjo el page fault
+ * @param address Direccion que se quiso acceder
+ * @param errorCode Codigo de error que dejo el CPU
+ * @return 0 si se resolvio, -1 si es un error o no hay marcos libres
+ */
+int64_t handleProcessPageFault(ProcessContext *process, uint64_t address, uint64_t errorCode);
+
+/**
+ * @brief Inicializa el PCB de un proceso hijo como copia del que llama a fork
+ * @note  El espacio de direcciones se duplica copy-on-write. El hijo arranca desde el frame que dejo el syscall en
+ *        el stack del padre, que en su copia esta en la misma direccion, con rax en 0
+ * @param child PCB a inicializar
+ * @param parent Proceso que llamo a fork
+ * @param pid ID del hijo
+ * @param syscallFrame Direccion de los registros guardados al entrar al syscall
+ * @return 0 en caso de éxito, -1 en caso de error
+ */
+int initializeForkedProcess(ProcessContext *child, ProcessContext *parent, int16_t pid, uint64_t syscallFrame);
+
 /**
  * @brief Configura el frame de la pila para un nuevo proceso
- * @param stackBase Dirección base de la pila
+ * @param stackBase Dirección base de la pila, tal como la ve quien arma el frame
  * @param code Dirección del código a ejecutar
  * @param argc Cantidad de argumentos
  * @param args Array de argumentos
- * @return Dirección del tope de la pila configurada
+ * @param processStack Dirección base de la pila en el espacio de direcciones del proceso
+ * @return Dirección del tope de la pila configurada, relativa a stackBase
  */
-extern uint64_t setupStackFrame(uint64_t stackBase, uint64_t code, int argc, char *args[]);
+extern uint64_t setupStackFrame(uint64_t stackBase, uint64_t code, int argc, char *args[], uint64_t processStack);
 
 #endif // PROCESS_H
\ No newline at end of file
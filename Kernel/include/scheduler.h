@@ -41,6 +41,7 @@ typedef struct ProcessInfo {
 
 	uint64_t stackBase;
 	uint64_t stackPos;
+	uint64_t memoryUsage; // bytes pedidos con sys_mm_alloc mas las paginas propias que el proceso llego a tocar
 } ProcessInfo;
 
 /**
@@ -55,6 +56,18 @@ void createScheduler();
  */
 uint64_t schedule(uint64_t prevRSP);
 
+/**
+ * @brief Devuelve la PML4 que tiene que quedar activa despues de schedule
+ * @return La del proceso actual, o la del kernel si no corre ninguno
+ */
+uint64_t getCurrentPageTable();
+
+/**
+ * @brief Devuelve el proceso que esta corriendo
+ * @return PCB del proceso actual, o NULL si no hay ninguno
+ */
+ProcessContext *getCurrentProcess();
+
 /**
  * @brief Crea un nuevo proceso
  * @param rip Dirección de inicio del código del proceso
@@ -67,6 +80,13 @@ uint64_t schedule(uint64_t prevRSP);
  */
 int16_t createProcess(uint64_t rip, char **args, int argc, uint8_t priority, int16_t fileDescriptors[], char ground);
 
+/**
+ * @brief Duplica el proceso actual copy-on-write
+ * @param syscallFrame Registros que guardo el syscall en el stack del proceso
+ * @return PID del hijo (el hijo ve 0), o -1 en caso de error
+ */
+int16_t forkProcess(uint64_t syscallFrame);
+
 /**
  * @brief Marca un proceso como listo para ejecutar
  * @param pid ID del proceso a marcar como listo
@@ -99,15 +119,22 @@ void yield();
  */
 int64_t killCurrentProcess();
 
+/**
+ * @brief Termina el proceso actual porque llamo a exit
+ * @return 0 en caso de éxito, -1 en caso de error
+ */
+int64_t exitCurrentProcess();
+
 /**
  * @brief Termina un proceso específico
+ * @note  Quien esta del otro lado de sus pipes no muere con el: recibe EOF o -1 al escribir y termina solo
  * @param pid ID del proceso a terminar
  * @return 0 en caso de éxito, -1 en caso de error
  */
 int64_t killProcess(int16_t pid);
 
 /**
- * @brief Termina el proceso en foreground actual
+ * @brief Termina los procesos en foreground, salvo la shell: todas las etapas de un pipeline
  * @return 0 en caso de éxito, -1 en caso de error
  */
 int64_t killForegroundProcess();
@@ -120,8 +147,8 @@ int16_t getPid();
 
 /**
  * @brief Obtiene el descriptor de archivo correspondiente
- * @param fd Número de descriptor de archivo
- * @return Descriptor de archivo o -1 en caso de error
+ * @param fd Número de descriptor de archivo, de 0 a CANT_FILE_DESCRIPTORS - 1
+ * @return Descriptor de archivo o -1 si 'fd' esta fuera de rango
  */
 int64_t getFd(int64_t fd);
 
@@ -132,6 +159,21 @@ int64_t getFd(int64_t fd);
  */
 ProcessInfo *ps(uint16_t *proccesQty);
 
+/**
+ * @brief Libera un bloque pedido desde userland, descontandolo del proceso que lo reservo
+ * @note  Primero busca en el proceso actual y despues en el resto. Si nadie lo tiene registrado es un bloque
+ *        compartido y se libera directamente
+ * @param ptr Bloque a liberar
+ */
+void freeFromOwner(void *ptr);
+
+/**
+ * @brief Elige al proceso a terminar cuando falta memoria: el que mas tiene contabilizada
+ * @note  Cuenta los bloques pedidos con sys_mm_alloc y las paginas propias. Nunca elige a idle ni a la shell
+ * @return PID del proceso elegido o -1 si no hay ninguno
+ */
+int16_t findLargestProcess();
+
 /**
  * @brief Copia la información de un proceso a una estructura ProcessInfo
  * @param dest Estructura destino
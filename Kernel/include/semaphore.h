@@ -61,6 +61,14 @@ int sem_wait(int id);
  */
 int sem_post(int id);
 
+/**
+ * @brief Saca de las colas de espera los PIDs de procesos que murieron bloqueados
+ * @note  sem_post los descarta al pasar, pero un semaforo sin posts los retiene para siempre. Se usa cuando falta
+ *        memoria; los semaforos que estan tomados se saltean
+ * @return Cantidad de entradas liberadas
+ */
+int sem_purgeWaiters();
+
 /**
  * @brief Adquiere un spinlock
  * @param lock Puntero al spinlock a adquirir
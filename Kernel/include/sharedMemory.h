@@ -0,0 +1,61 @@
+#ifndef SHARED_MEMORY_H
+#define SHARED_MEMORY_H
+
+#include "scheduler.h"
+#include <stdint.h>
+
+#define MAX_SHM_SEGMENTS 32
+
+/*
+ * Segmento de memoria compartida. El bloque sale del heap del kernel, que esta mapeado en el mismo lugar para todos
+ * los procesos, asi que adjuntarlo es devolver su direccion: los datos nunca se copian. Por eso un segmento no puede
+ * pasar de MM_MAX_ALLOC (128 KiB), lo mas grande que entrega mm_alloc.
+ */
+typedef struct {
+	int key;
+	void *address;
+	uint64_t size;
+	uint32_t references;				 // cantidad total de adjuntos vivos
+	uint8_t attachments[MAX_PROCESS]; // adjuntos por pid, para soltarlos si el proceso muere; hasta UINT8_MAX
+	uint8_t isOpen;
+} shmSegment_t;
+
+typedef struct {
+	shmSegment_t segments[MAX_SHM_SEGMENTS];
+} shmManager;
+
+/**
+ * @brief Inicializa la tabla de segmentos compartidos
+ */
+void initializeSharedMemoryManager();
+
+/**
+ * @brief Crea un segmento identificado por 'key' y lo adjunta al proceso actual
+ * @param key Clave que usan los demas procesos para adjuntarse
+ * @param size Tamaño del segmento en bytes, hasta MM_MAX_ALLOC (128 KiB)
+ * @return Direccion del segmento, o NULL si la clave ya existe, no quedan segmentos, el tamaño pasa de
+ *         MM_MAX_ALLOC o no hay memoria
+ */
+void *createSharedMemory(int key, uint64_t size);
+
+/**
+ * @brief Adjunta al proceso actual un segmento existente
+ * @param key Clave del segmento
+ * @return Direccion del segmento, o NULL si no existe o el proceso ya lo tiene adjunto UINT8_MAX veces
+ */
+void *attachSharedMemory(int key);
+
+/**
+ * @brief Suelta un adjunto del proceso actual; el segmento se libera cuando no le queda ninguno
+ * @param key Clave del segmento
+ * @return 0 en caso de éxito, -1 si el proceso no lo tenia adjunto
+ */
+int detachSharedMemory(int key);
+
+/**
+ * @brief Suelta todos los adjuntos de un proceso que termina
+ * @param pid ID del proceso
+ */
+void detachAllSharedMemory(int16_t pid);
+
+#endif
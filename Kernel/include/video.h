@@ -79,6 +79,16 @@ void printNChars(char c, int n);
  */
 uint32_t getScreenResolution();
 
+/**
+ * @brief  Devuelve la direccion fisica del framebuffer
+ */
+uint64_t getFramebufferAddress();
+
+/**
+ * @brief  Devuelve cuantos bytes ocupa el framebuffer visible
+ */
+uint64_t getFramebufferSize();
+
 /**
  * @brief  Cambia el color de la letra
  * @param  color: Nuevo color
@@ -0,0 +1,57 @@
+#ifndef WAIT_QUEUE_H
+#define WAIT_QUEUE_H
+
+#include <stdint.h>
+
+/*
+ * Cola de procesos bloqueados esperando una condicion. A diferencia de los semaforos no ocupa un id global ni
+ * cuenta posts: quien espera revisa su condicion al despertar y, si sigue sin cumplirse, vuelve a dormir.
+ */
+typedef struct waitQueueCDT *waitQueueADT;
+
+/**
+ * @brief Crea una cola de espera vacia
+ * @return La cola, o NULL si no hay memoria
+ */
+waitQueueADT createWaitQueue();
+
+/**
+ * @brief Libera la cola y las entradas que hayan quedado
+ * @note  No despierta a nadie: quien la destruye tiene que despertar antes a los que esperan
+ */
+void freeWaitQueue(waitQueueADT queue);
+
+/**
+ * @brief Bloquea al proceso actual en la cola
+ * @note  Suelta 'lock' antes de bloquearse y no lo vuelve a tomar: mientras el proceso dormia el objeto que lo
+ *        contiene pudo haberse liberado, asi que quien llama tiene que volver a buscarlo antes de tocarlo
+ * @param queue Cola en la que esperar
+ * @param lock Spinlock que protege la condicion, tomado por quien llama
+ * @return 0 al despertar (sin el lock), o -1 si no se pudo encolar (sin bloquearse y con el lock tomado)
+ */
+int waitQueueSleep(waitQueueADT queue, uint8_t *lock);
+
+/**
+ * @brief Anota un proceso en la cola sin bloquearlo
+ * @note  Sirve para esperar en varias colas a la vez: quien llama se bloquea despues y, al despertar, se saca de las
+ *        otras con waitQueueRemove
+ * @param queue Cola en la que anotarlo
+ * @param pid Proceso a anotar
+ * @return 0 en caso de éxito, -1 si no hay memoria
+ */
+int waitQueueAdd(waitQueueADT queue, int16_t pid);
+
+/**
+ * @brief Saca de la cola la entrada de un proceso, si todavia la tiene
+ * @param queue Cola de la que sacarlo
+ * @param pid Proceso a sacar
+ */
+void waitQueueRemove(waitQueueADT queue, int16_t pid);
+
+/**
+ * @brief Despierta a todos los procesos de la cola
+ * @return Cantidad de procesos despertados
+ */
+int waitQueueWakeAll(waitQueueADT queue);
+
+#endif
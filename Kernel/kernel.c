@@ -4,10 +4,16 @@
 #include "include/interrupts.h"
 #include "include/lib.h"
 #include "include/memoryManagement.h"
+#include "include/memoryMap.h"
+#include "include/messageQueue.h"
+#include "include/memoryPressure.h"
 #include "include/moduleLoader.h"
+#include "include/paging.h"
 #include "include/pipes.h"
+#include "include/poll.h"
 #include "include/scheduler.h"
 #include "include/semaphore.h"
+#include "include/sharedMemory.h"
 #include "include/video.h"
 #include "keyboard.h"
 #include <stdint.h>
@@ -20,6 +26,7 @@ extern uint8_t endOfKernelBinary;
 extern uint8_t endOfKernel;
 
 static const uint64_t PageSize = 0x1000;
+static const uint64_t FramePoolDivisor = 4; // Fraccion de la region libre que se reserva para paginas de procesos
 
 static void *const sampleCodeModuleAddress = (void *) 0x400000;
 static void *const sampleDataModuleAddress = (void *) 0x500000;
@@ -27,6 +34,7 @@ static void *const memoryManagerModuleAddress = (void *) 0x600000;
 
 typedef int (*EntryPoint)();
 MemoryManagerADT memoryManager;
+uint64_t heapInitCycles;
 
 void clearBSS(void *bssAddress, uint64_t bssSize) {
 	memset(bssAddress, 0, bssSize);
@@ -49,7 +57,32 @@ int main() {
 
 	_cli();
 
-	memoryManager = mm_create(memoryManagerModuleAddress, HEAP_SIZE);
+	// El heap ocupa la region de RAM libre mas grande por encima de los modulos
+	memoryRegion_t heap = getLargestUsableRegion((uint64_t) memoryManagerModuleAddress);
+	if (heap.size == 0) {
+		heap.start = (uint64_t) memoryManagerModuleAddress;
+		heap.size = HEAP_SIZE;
+	}
+
+	// El final de la region queda como pool de marcos para las tablas de paginas y la memoria propia de los procesos
+	uint64_t regionEnd = heap.start + heap.size;
+	uint64_t poolStart = (regionEnd - heap.size / FramePoolDivisor) & ~(PageSize - 1);
+	heap.size = poolStart - heap.start;
+	if (initPaging(poolStart, regionEnd - poolStart, heap.start, regionEnd) == -1) {
+		print("Hubo un error al inicializar la paginacion.");
+		while (1)
+			_hlt();
+	}
+
+	uint64_t heapInitStart = _rdtsc();
+	memoryManager = mm_create((void *) heap.start, heap.size);
+	heapInitCycles = _rdtsc() - heapInitStart;
+	if (memoryManager == NULL) {
+		print("Hubo un error al inicializar el heap.");
+		while (1)
+			_hlt();
+	}
+	initMemoryPressure();
 
 	createScheduler();
 
@@ -61,6 +94,12 @@ int main() {
 
 	initializePipeManager();
 
+	initializePoll();
+
+	initializeMessageQueues();
+
+	initializeSharedMemoryManager();
+
 	initializeKeyboardDriver();
 
 	char *argsShell[1] = {"shell"};
@@ -0,0 +1,45 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+#include "include/memoryMap.h"
+#include <stdint.h>
+
+#define E820_MAP_ADDRESS 0x4000
+#define E820_USABLE 1
+#define MAPPED_LIMIT ((uint64_t) 64 * 1024 * 1024 * 1024) // Pure64 mapea por identidad los primeros 64 GiB
+
+/*
+ * Entrada del mapa de memoria tal como la guarda Pure64: cada una ocupa 32 bytes y el mapa termina con una de tipo 0.
+ */
+typedef struct e820Entry {
+	uint64_t base;
+	uint64_t length;
+	uint32_t type;
+	uint32_t extendedAttributes;
+	uint64_t padding;
+} e820Entry_t;
+
+memoryRegion_t getLargestUsableRegion(uint64_t minAddress) {
+	memoryRegion_t best = {0, 0};
+	e820Entry_t *entry = (e820Entry_t *) E820_MAP_ADDRESS;
+
+	for (; entry->type != 0; entry++) {
+		if (entry->type != E820_USABLE) {
+			continue;
+		}
+
+		uint64_t start = entry->base;
+		uint64_t end = entry->base + entry->length;
+		if (start < minAddress) {
+			start = minAddress;
+		}
+		if (end > MAPPED_LIMIT) {
+			end = MAPPED_LIMIT;
+		}
+		if (end > start && end - start > best.size) {
+			best.start = start;
+			best.size = end - start;
+		}
+	}
+	return best;
+}
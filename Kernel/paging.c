@@ -0,0 +1,368 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+#include "include/paging.h"
+#include "include/lib.h"
+#include "include/video.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#define ENTRIES_PER_TABLE 512
+#define PAGE_PRESENT 0x1
+#define PAGE_WRITABLE 0x2
+#define PAGE_LARGE 0x80 // En un PD: la entrada mapea 2 MiB en lugar de apuntar a una tabla
+#define PAGE_COW 0x200	// Bit libre para el sistema: pagina compartida despues de un fork, se copia al escribirla
+#define PAGE_FLAGS (PAGE_PRESENT | PAGE_WRITABLE)
+#define ADDRESS_MASK 0x000FFFFFFFFFF000ULL
+#define TOP_LEVEL_SHIFT 39
+#define LEVEL_BITS 9
+#define PAGE_SHIFT 12
+#define LARGE_PAGE_SHIFT 21
+#define LARGE_PAGE_SIZE (1ULL << LARGE_PAGE_SHIFT)
+#define PDPT_LEVEL 3
+#define KERNEL_ENTRIES 1 // La entrada 0 de la PML4 (primeros 512 GiB) es el mapa del kernel y la comparten todos
+
+#define PAGE_ALIGN_UP(x) (((x) + PAGE_MASK) & ~(uint64_t) PAGE_MASK)
+
+/*
+ * Pool de marcos: los que nunca se usaron se entregan avanzando 'nextFrame' y los devueltos se apilan en un
+ * arreglo al principio del pool. Guardarlos afuera de los marcos permite liberar el espacio de direcciones activo.
+ * Despues de la pila va la cantidad de referencias de cada marco: un fork comparte paginas entre procesos y el marco
+ * vuelve al pool recien cuando lo suelta el ultimo.
+ */
+static uint64_t *freeFrames;
+static uint64_t freeCount;
+static uint16_t *references;
+static uint64_t framesStart;
+static uint64_t nextFrame;
+static uint64_t poolEnd;
+
+static uint64_t kernelPageTable;
+static uint64_t bootPageTable;
+
+static uint64_t takeFrame();
+static uint64_t allocFrame();
+static void freeFrame(uint64_t frame);
+static uint16_t *frameReferences(uint64_t frame);
+static uint64_t cloneTable(uint64_t table, int level);
+static uint64_t *walk(uint64_t pageTable, uint64_t virtualAddress, int create, int lastShift);
+static int mapIdentity(uint64_t start, uint64_t end, int largePages);
+static void freeTable(uint64_t table, int level);
+
+int initPaging(uint64_t poolStart, uint64_t poolSize, uint64_t heapStart, uint64_t identityEnd) {
+	// Si el kernel se reinicia despues de una excepcion se vuelve a las tablas de Pure64 antes de pisar el pool
+	if (bootPageTable == 0) {
+		bootPageTable = _readCR3();
+	}
+	else {
+		_writeCR3(bootPageTable);
+	}
+
+	uint64_t start = PAGE_ALIGN_UP(poolStart);
+	poolEnd = (poolStart + poolSize) & ~(uint64_t) PAGE_MASK;
+	if (poolEnd <= start) {
+		return -1;
+	}
+	uint64_t frames = (poolEnd - start) / PAGE_SIZE;
+	uint64_t metadataBytes = PAGE_ALIGN_UP(frames * (sizeof(uint64_t) + sizeof(uint16_t)));
+	if (metadataBytes >= poolEnd - start) {
+		return -1;
+	}
+	freeFrames = (uint64_t *) start;
+	freeCount = 0;
+	references = (uint16_t *) (start + frames * sizeof(uint64_t));
+	framesStart = start + metadataBytes;
+	nextFrame = framesStart;
+
+	kernelPageTable = allocFrame();
+	if (kernelPageTable == 0) {
+		return -1;
+	}
+	// El heap, el pool y el framebuffer se recorren enteros seguido: con paginas de 2 MiB ocupan una entrada de TLB
+	// cada 512 paginas chicas y no necesitan tablas de ultimo nivel
+	uint64_t framebuffer = getFramebufferAddress();
+	if (mapIdentity(0, heapStart, 0) == -1 || mapIdentity(heapStart, identityEnd, 1) == -1 ||
+		mapIdentity(framebuffer, framebuffer + getFramebufferSize(), 1) == -1) {
+		return -1;
+	}
+
+	_writeCR3(kernelPageTable);
+	// Sin WP el CPU ignora el bit de escritura en ring 0 y las paginas compartidas por un fork no se copiarian
+	_enableWriteProtect();
+	return 0;
+}
+
+uint64_t getKernelPageTable() {
+	return kernelPageTable;
+}
+
+uint64_t createAddressSpace() {
+	uint64_t pageTable = allocFrame();
+	if (pageTable == 0) {
+		return 0;
+	}
+	// Se comparte la tabla de abajo, asi que lo que el kernel mapee despues lo ven todos los procesos
+	((uint64_t *) pageTable)[0] = ((uint64_t *) kernelPageTable)[0];
+	return pageTable;
+}
+
+void destroyAddressSpace(uint64_t pageTable) {
+	uint64_t *entries = (uint64_t *) pageTable;
+	for (int i = KERNEL_ENTRIES; i < ENTRIES_PER_TABLE; i++) {
+		if (entries[i] & PAGE_PRESENT) {
+			freeTable(entries[i] & ADDRESS_MASK, PDPT_LEVEL);
+		}
+	}
+	freeFrame(pageTable);
+}
+
+uint64_t mapNewPage(uint64_t pageTable, uint64_t virtualAddress) {
+	uint64_t *entry = walk(pageTable, virtualAddress, 1, PAGE_SHIFT);
+	if (entry == NULL || (*entry & PAGE_PRESENT)) {
+		return 0;
+	}
+	uint64_t frame = allocFrame();
+	if (frame == 0) {
+		return 0;
+	}
+	*entry = frame | PAGE_FLAGS;
+	return frame;
+}
+
+uint64_t cloneAddressSpace(uint64_t pageTable) {
+	uint64_t clone = createAddressSpace();
+	if (clone == 0) {
+		return 0;
+	}
+
+	uint64_t *source = (uint64_t *) pageTable;
+	for (int i = KERNEL_ENTRIES; i < ENTRIES_PER_TABLE; i++) {
+		if (!(source[i] & PAGE_PRESENT)) {
+			continue;
+		}
+		uint64_t table = cloneTable(source[i] & ADDRESS_MASK, PDPT_LEVEL);
+		if (table == 0) {
+			destroyAddressSpace(clone);
+			return 0;
+		}
+		((uint64_t *) clone)[i] = table | PAGE_FLAGS;
+	}
+
+	// Las paginas del original pasaron a ser de solo lectura: se descartan las traducciones que permitian escribirlas
+	if ((_readCR3() & ADDRESS_MASK) == pageTable) {
+		_writeCR3(pageTable);
+	}
+	return clone;
+}
+
+uint64_t makePageWritable(uint64_t pageTable, uint64_t virtualAddress, int *copied) {
+	if (copied != NULL) {
+		*copied = 0;
+	}
+	uint64_t *entry = walk(pageTable, virtualAddress, 0, PAGE_SHIFT);
+	if (entry == NULL || !(*entry & PAGE_PRESENT) || (*entry & PAGE_LARGE)) {
+		return 0;
+	}
+	uint64_t frame = *entry & ADDRESS_MASK;
+	if (*entry & PAGE_WRITABLE) {
+		return frame;
+	}
+	if (!(*entry & PAGE_COW)) {
+		return 0;
+	}
+
+	// Si el otro proceso ya se quedo con su copia el marco es de este y alcanza con volver a habilitar la escritura
+	if (*frameReferences(frame) > 1) {
+		uint64_t copy = takeFrame();
+		if (copy == 0) {
+			return 0;
+		}
+		memcpy((void *) copy, (void *) frame, PAGE_SIZE);
+		freeFrame(frame);
+		frame = copy;
+		if (copied != NULL) {
+			*copied = 1;
+		}
+	}
+	*entry = frame | PAGE_FLAGS;
+
+	if ((_readCR3() & ADDRESS_MASK) == pageTable) {
+		_invlpg(virtualAddress);
+	}
+	return frame;
+}
+
+int unmapPage(uint64_t pageTable, uint64_t virtualAddress) {
+	uint64_t *entry = walk(pageTable, virtualAddress, 0, PAGE_SHIFT);
+	if (entry == NULL || !(*entry & PAGE_PRESENT) || (*entry & PAGE_LARGE)) {
+		return -1;
+	}
+	freeFrame(*entry & ADDRESS_MASK);
+	*entry = 0;
+	if ((_readCR3() & ADDRESS_MASK) == pageTable) {
+		_invlpg(virtualAddress);
+	}
+	return 0;
+}
+
+/**
+ * @brief Entrega un marco del pool con una referencia y sin limpiar
+ * @return Direccion fisica del marco, o 0 si el pool se agoto
+ */
+static uint64_t takeFrame() {
+	uint64_t frame;
+	if (freeCount > 0) {
+		frame = freeFrames[--freeCount];
+	}
+	else if (nextFrame < poolEnd) {
+		frame = nextFrame;
+		nextFrame += PAGE_SIZE;
+	}
+	else {
+		return 0;
+	}
+	*frameReferences(frame) = 1;
+	return frame;
+}
+
+/**
+ * @brief Entrega un marco del pool lleno de ceros
+ */
+static uint64_t allocFrame() {
+	uint64_t frame = takeFrame();
+	if (frame != 0) {
+		memset((void *) frame, 0, PAGE_SIZE);
+	}
+	return frame;
+}
+
+/**
+ * @brief Suelta una referencia al marco y lo devuelve al pool si era la ultima
+ */
+static void freeFrame(uint64_t frame) {
+	uint16_t *count = frameReferences(frame);
+	if (--(*count) == 0) {
+		freeFrames[freeCount++] = frame;
+	}
+}
+
+static uint16_t *frameReferences(uint64_t frame) {
+	return &references[(frame - framesStart) / PAGE_SIZE];
+}
+
+/**
+ * @brief Recorre las tablas hasta la entrada que corresponde a una direccion virtual
+ * @note  Las tablas son accesibles porque el pool esta dentro del mapa por identidad
+ * @param  create: Si es distinto de 0 crea las tablas intermedias que falten
+ * @param  lastShift: PAGE_SHIFT para llegar a la entrada de una pagina de 4 KiB, LARGE_PAGE_SHIFT para la de un PD
+ * @return Puntero a la entrada, o NULL si falta una tabla y no se pidio crearla (o no hay marcos). Si en el camino
+ *         hay una pagina de 2 MiB se devuelve su entrada
+ */
+static uint64_t *walk(uint64_t pageTable, uint64_t virtualAddress, int create, int lastShift) {
+	uint64_t *table = (uint64_t *) pageTable;
+	for (int shift = TOP_LEVEL_SHIFT; shift > lastShift; shift -= LEVEL_BITS) {
+		uint64_t *entry = &table[(virtualAddress >> shift) & (ENTRIES_PER_TABLE - 1)];
+		if (*entry & PAGE_LARGE) {
+			return entry;
+		}
+		if (!(*entry & PAGE_PRESENT)) {
+			if (!create) {
+				return NULL;
+			}
+			uint64_t frame = allocFrame();
+			if (frame == 0) {
+				return NULL;
+			}
+			*entry = frame | PAGE_FLAGS;
+		}
+		table = (uint64_t *) (*entry & ADDRESS_MASK);
+	}
+	return &table[(virtualAddress >> lastShift) & (ENTRIES_PER_TABLE - 1)];
+}
+
+/**
+ * @brief Mapea por identidad un rango en el espacio del kernel
+ * @param  largePages: Si es distinto de 0 usa paginas de 2 MiB en la parte alineada del rango
+ */
+static int mapIdentity(uint64_t start, uint64_t end, int largePages) {
+	uint64_t page = start & ~(uint64_t) PAGE_MASK;
+	while (page < end) {
+		int large = largePages && (page & (LARGE_PAGE_SIZE - 1)) == 0 && end - page >= LARGE_PAGE_SIZE;
+		uint64_t *entry = walk(kernelPageTable, page, 1, large ? LARGE_PAGE_SHIFT : PAGE_SHIFT);
+		if (entry == NULL) {
+			return -1;
+		}
+
+		if (*entry & PAGE_LARGE) {
+			// Ya lo cubre una pagina grande (por ejemplo el framebuffer dentro de la RAM)
+			page = (page & ~(LARGE_PAGE_SIZE - 1)) + LARGE_PAGE_SIZE;
+			continue;
+		}
+		if (large) {
+			*entry = page | PAGE_FLAGS | PAGE_LARGE;
+			page += LARGE_PAGE_SIZE;
+		}
+		else {
+			*entry = page | PAGE_FLAGS;
+			page += PAGE_SIZE;
+		}
+	}
+	return 0;
+}
+
+/**
+ * @brief Copia una tabla y las que cuelgan de ella; las paginas se comparten y quedan de solo lectura en ambos lados
+ * @param  level: 3 para una PDPT, 2 para un PD y 1 para una tabla de paginas
+ * @return Direccion fisica de la copia, o 0 si no hay marcos
+ */
+static uint64_t cloneTable(uint64_t table, int level) {
+	uint64_t copy = allocFrame();
+	if (copy == 0) {
+		return 0;
+	}
+
+	uint64_t *entries = (uint64_t *) table;
+	uint64_t *copyEntries = (uint64_t *) copy;
+	for (int i = 0; i < ENTRIES_PER_TABLE; i++) {
+		if (!(entries[i] & PAGE_PRESENT)) {
+			continue;
+		}
+		if (level > 1) {
+			uint64_t child = cloneTable(entries[i] & ADDRESS_MASK, level - 1);
+			if (child == 0) {
+				freeTable(copy, level);
+				return 0;
+			}
+			copyEntries[i] = child | (entries[i] & ~ADDRESS_MASK);
+		}
+		else {
+			if (entries[i] & PAGE_WRITABLE) {
+				entries[i] = (entries[i] & ~(uint64_t) PAGE_WRITABLE) | PAGE_COW;
+			}
+			copyEntries[i] = entries[i];
+			(*frameReferences(entries[i] & ADDRESS_MASK))++;
+		}
+	}
+	return copy;
+}
+
+/**
+ * @brief Libera una tabla, las tablas que cuelgan de ella y las paginas a las que apuntan
+ * @note  Las paginas compartidas con otro proceso solo pierden una referencia
+ * @param  level: 3 para una PDPT, 2 para un PD y 1 para una tabla de paginas
+ */
+static void freeTable(uint64_t table, int level) {
+	uint64_t *entries = (uint64_t *) table;
+	for (int i = 0; i < ENTRIES_PER_TABLE; i++) {
+		if (!(entries[i] & PAGE_PRESENT)) {
+			continue;
+		}
+		if (level > 1) {
+			freeTable(entries[i] & ADDRESS_MASK, level - 1);
+		}
+		else {
+			freeFrame(entries[i] & ADDRESS_MASK);
+		}
+	}
+	freeFrame(table);
+}
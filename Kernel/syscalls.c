@@ -2,16 +2,23 @@
 #include "include/keyboard.h"
 #include "include/lib.h"
 #include "include/memory.h"
+#include "include/memProfiler.h"
 #include "include/memoryManagement.h"
+#include "include/messageQueue.h"
 #include "include/pipes.h"
+#include "include/poll.h"
 #include "include/process.h"
 #include "include/scheduler.h"
 #include "include/semaphore.h"
+#include "include/sharedMemory.h"
 #include "include/time.h"
 #include "include/video.h"
 #include <stdint.h>
 
-#define SYSCALL_COUNT 36
+extern uint64_t heapInitCycles;
+extern uint64_t syscallFrame;
+
+#define SYSCALL_COUNT 59
 
 // File Descriptors
 #define STDIN 0
@@ -19,6 +26,14 @@
 #define STDERR 2
 #define KBDIN 3
 
+/*
+ * Tramo de memoria para readv/writev. Debe coincidir con iovec_t de userland
+ */
+typedef struct iovec {
+	void *base;
+	uint64_t length;
+} iovec_t;
+
 // IDs de syscalls
 #define READ 0
 #define WRITE 1
@@ -56,11 +71,42 @@
 #define PIPE_READ 33
 #define PIPE_WRITE 34
 #define PIPE_CLOSE 35
+#define MM_ALLOC_SHARED 36
+#define MM_STATS 37
+#define MM_PROFILE_SITES 38
+#define SBRK 39
+#define SHM_CREATE 40
+#define SHM_ATTACH 41
+#define SHM_DETACH 42
+#define FORK 43
+#define READ_BUFFER 44
+#define WRITE_BUFFER 45
+#define READV 46
+#define WRITEV 47
+#define PIPE_SET_CAPACITY 48
+#define SPLICE 49
+#define POLL 50
+#define GET_FD_FLAGS 51
+#define SET_FD_FLAGS 52
+#define PIPE_OPEN 53
+#define PIPE_CLOSE_END 54
+#define MQ_OPEN 55
+#define MQ_CLOSE 56
+#define MQ_SEND 57
+#define MQ_RECEIVE 58
 
 static uint8_t syscall_read(uint32_t fd);
 
 static void syscall_write(uint32_t fd, char c);
 
+static int64_t syscall_read_buffer(uint32_t fd, char *buffer, uint64_t count);
+
+static int64_t syscall_write_buffer(uint32_t fd, const char *buffer, uint64_t count);
+
+static int64_t syscall_readv(uint32_t fd, const iovec_t *iov, uint32_t iovcnt);
+
+static int64_t syscall_writev(uint32_t fd, const iovec_t *iov, uint32_t iovcnt);
+
 static void syscall_clear();
 
 static uint32_t syscall_seconds();
@@ -89,6 +135,14 @@ static void syscall_mm_free(void *const restrict ptr);
 
 static void syscall_mm_info(mem_t *info);
 
+static void *syscall_sbrk(int64_t increment) {
+	return processSbrk(getCurrentProcess(), increment);
+}
+
+static int64_t syscall_fork() {
+	return forkProcess(syscallFrame);
+}
+
 static uint64_t syscall_create_process(uint64_t rip, char **args, int argc, uint8_t priority, char ground,
 									   int16_t fileDescriptors[]);
 
@@ -118,6 +172,46 @@ static int64_t syscall_pipe_write(int pipe_id, const char *buffer, int size);
 
 static int64_t syscall_pipe_close(int pipe_id);
 
+static int64_t syscall_pipe_setCapacity(int pipe_id, int capacity);
+
+static int64_t syscall_pipe_open(const char *name, int end);
+
+static int64_t syscall_pipe_close_end(int pipe_id, int end);
+
+static int64_t syscall_mq_open(const char *name, int depth, int maxSize);
+
+static int64_t syscall_mq_close(int id);
+
+static int64_t syscall_mq_send(int id, const char *message, int length, int priority);
+
+static int64_t syscall_mq_receive(int id, char *buffer, int size, int *priority);
+
+static int64_t syscall_splice(uint32_t fdIn, uint32_t fdOut, uint64_t count);
+
+static int64_t syscall_poll(pollfd_t *fds, uint32_t nfds, int64_t timeout);
+
+static int64_t syscall_get_fd_flags(uint32_t fd);
+
+static int64_t syscall_set_fd_flags(uint32_t fd, uint32_t flags);
+
+static int isNonBlocking(uint32_t fd);
+
+static int isPipeNonBlocking(int pipe_id);
+
+static void printData(const char *data, int length);
+
+static void printErrorData(const char *data, int length);
+
+static uint64_t syscall_removed();
+
+static void syscall_mm_stats(mm_stats_t *stats);
+
+static int64_t syscall_mm_profile(memProfileSite_t *sites, uint32_t max);
+
+static void *syscall_sbrk(int64_t increment);
+
+static int64_t syscall_fork();
+
 typedef uint64_t (*syscall)(uint64_t, uint64_t, uint64_t, uint64_t, uint64_t, uint64_t);
 
 static const syscall syscalls[] = {
@@ -157,6 +251,29 @@ static const syscall syscalls[] = {
 	(syscall) syscall_pipe_read,
 	(syscall) syscall_pipe_write,
 	(syscall) syscall_pipe_close,
+	(syscall) syscall_removed, // era sys_mm_alloc_shared; el lugar se conserva para no correr los numeros
+	(syscall) syscall_mm_stats,
+	(syscall) syscall_mm_profile,
+	(syscall) syscall_sbrk,
+	(syscall) createSharedMemory,
+	(syscall) attachSharedMemory,
+	(syscall) detachSharedMemory,
+	(syscall) syscall_fork,
+	(syscall) syscall_read_buffer,
+	(syscall) syscall_write_buffer,
+	(syscall) syscall_readv,
+	(syscall) syscall_writev,
+	(syscall) syscall_pipe_setCapacity,
+	(syscall) syscall_splice,
+	(syscall) syscall_poll,
+	(syscall) syscall_get_fd_flags,
+	(syscall) syscall_set_fd_flags,
+	(syscall) syscall_pipe_open,
+	(syscall) syscall_pipe_close_end,
+	(syscall) syscall_mq_open,
+	(syscall) syscall_mq_close,
+	(syscall) syscall_mq_send,
+	(syscall) syscall_mq_receive,
 };
 
 uint64_t syscallDispatcher(uint64_t nr, uint64_t arg0, uint64_t arg1, uint64_t arg2, uint64_t arg3, uint64_t arg4,
@@ -172,7 +289,10 @@ static uint8_t syscall_read(uint32_t fd) {
 	// si es un pipe (FD >= 3), leer del pipe
 	if (realFd >= 3) {
 		char buffer;
-		int64_t bytesRead = readPipe(realFd, &buffer, 1);
+		int64_t bytesRead = readPipe(realFd, &buffer, 1, isNonBlocking(fd));
+		if (bytesRead == WOULD_BLOCK) {
+			return 0;
+		}
 		if (bytesRead <= 0) {
 			return (uint8_t) (-1);
 		}
@@ -181,6 +301,10 @@ static uint8_t syscall_read(uint32_t fd) {
 
 	switch (realFd) {
 		case STDIN:
+			// en modo no bloqueante un 0 es "todavia no hay nada", igual que KBDIN
+			if (isNonBlocking(fd) && pendingKeys() == 0) {
+				return 0;
+			}
 			return getAscii();
 		case KBDIN:
 			return getScancode();
@@ -193,7 +317,7 @@ static void syscall_write(uint32_t fd, char c) {
 
 	// si es un pipe (FD >= 3), escribir al pipe
 	if (realFd >= 3) {
-		writePipe(realFd, &c, 1);
+		writePipe(realFd, &c, 1, isNonBlocking(fd));
 		return;
 	}
 
@@ -211,6 +335,142 @@ static void syscall_write(uint32_t fd, char c) {
 	setFontColor(prevColor);
 }
 
+/**
+ * @brief Lee hasta 'count' bytes de un descriptor con una sola entrada al kernel
+ * @note  Del teclado espera la primera tecla y despues solo se lleva las que ya estan en el buffer; un EOF corta la
+ *        lectura y se devuelve como un byte mas, igual que con syscall_read. Un pipe devuelve lo que tenga. Con
+ *        FD_NONBLOCK, si no hay nada, devuelve WOULD_BLOCK
+ * @return Bytes leidos, WOULD_BLOCK, o -1 si el pipe llego a EOF o el descriptor no se puede leer
+ */
+static int64_t syscall_read_buffer(uint32_t fd, char *buffer, uint64_t count) {
+	int16_t realFd = getFd(fd);
+	if (buffer == NULL || count == 0) {
+		return 0;
+	}
+
+	if (realFd >= 3) {
+		return readPipe(realFd, buffer, count > INT32_MAX ? INT32_MAX : (int) count, isNonBlocking(fd));
+	}
+
+	uint64_t read = 0;
+	switch (realFd) {
+		case STDIN:
+			if (isNonBlocking(fd) && pendingKeys() == 0) {
+				return WOULD_BLOCK;
+			}
+			do {
+				buffer[read] = getAscii();
+			} while (buffer[read++] != (char) -1 && read < count && pendingKeys() > 0);
+			return read;
+		case KBDIN:
+			while (read < count && pendingKeys() > 0) {
+				buffer[read++] = getScancode();
+			}
+			return read;
+	}
+	return -1;
+}
+
+/**
+ * @brief Escribe 'count' bytes en un descriptor con una sola entrada al kernel
+ * @return Bytes escritos, o -1 si el descriptor no se puede escribir
+ */
+static int64_t syscall_write_buffer(uint32_t fd, const char *buffer, uint64_t count) {
+	int16_t realFd = getFd(fd);
+	if (buffer == NULL) {
+		return -1;
+	}
+
+	if (realFd >= 3) {
+		int size = count > INT32_MAX ? INT32_MAX : (int) count;
+		return size == 0 ? 0 : writePipe(realFd, buffer, size, isNonBlocking(fd));
+	}
+
+	if (realFd != STDOUT && realFd != STDERR) {
+		return -1;
+	}
+
+	if (count > INT32_MAX) {
+		count = INT32_MAX;
+	}
+	Color prevColor = getFontColor();
+	if (realFd == STDERR)
+		setFontColor(ERROR_COLOR);
+	printData(buffer, (int) count);
+	setFontColor(prevColor);
+	return count;
+}
+
+/**
+ * @brief Dibuja un tramo en pantalla con el color actual
+ * @note  Tiene la forma de pipeConsumer para que splice imprima directo desde el buffer de un pipe
+ */
+static void printData(const char *data, int length) {
+	for (int i = 0; i < length; i++) {
+		// igual que syscall_write, el EOF no se dibuja
+		if (data[i] != (char) -1) {
+			printChar(data[i]);
+		}
+	}
+}
+
+static void printErrorData(const char *data, int length) {
+	Color prevColor = getFontColor();
+	setFontColor(ERROR_COLOR);
+	printData(data, length);
+	setFontColor(prevColor);
+}
+
+/**
+ * @brief Lee en varios tramos con una sola entrada al kernel
+ * @note  Se corta en el primer tramo que no se llena, para no bloquear esperando datos que quizas no lleguen
+ * @return Bytes leidos entre todos los tramos, o -1 si el primero ya fallo
+ */
+static int64_t syscall_readv(uint32_t fd, const iovec_t *iov, uint32_t iovcnt) {
+	if (iov == NULL) {
+		return -1;
+	}
+
+	int64_t total = 0;
+	for (uint32_t i = 0; i < iovcnt; i++) {
+		if (iov[i].length == 0) {
+			continue;
+		}
+		int64_t read = syscall_read_buffer(fd, iov[i].base, iov[i].length);
+		if (read < 0) {
+			return total > 0 ? total : read;
+		}
+		total += read;
+		if ((uint64_t) read < iov[i].length) {
+			break;
+		}
+	}
+	return total;
+}
+
+/**
+ * @brief Escribe varios tramos, en orden, con una sola entrada al kernel
+ * @return Bytes escritos entre todos los tramos, o -1 si el primero ya fallo
+ */
+static int64_t syscall_writev(uint32_t fd, const iovec_t *iov, uint32_t iovcnt) {
+	if (iov == NULL) {
+		return -1;
+	}
+
+	int64_t total = 0;
+	for (uint32_t i = 0; i < iovcnt; i++) {
+		int64_t written = syscall_write_buffer(fd, iov[i].base, iov[i].length);
+		if (written < 0) {
+			return total > 0 ? total : written;
+		}
+		total += written;
+		if ((uint64_t) written < iov[i].length) {
+			break;
+		}
+	}
+	return total;
+}
+
 static void syscall_clear() {
 	videoClear();
 }
@@ -266,17 +526,30 @@ static uint32_t syscall_getFontColor() {
 }
 
 static void *syscall_mm_alloc(size_t size) {
-	return mm_alloc(size);
+	return processAlloc(findProcess(getPid()), size);
 }
 
 static void syscall_mm_free(void *const restrict ptr) {
-	mm_free(ptr);
+	freeFromOwner(ptr);
+}
+
+static uint64_t syscall_removed() {
+	return 0;
 }
 
 static void syscall_mm_info(mem_t *info) {
 	*info = mm_info();
 }
 
+static void syscall_mm_stats(mm_stats_t *stats) {
+	mm_stats(stats);
+	stats->initCycles = heapInitCycles;
+}
+
+static int64_t syscall_mm_profile(memProfileSite_t *sites, uint32_t max) {
+	return memProfilerTopSites(sites, max);
+}
+
 static uint64_t syscall_create_process(uint64_t rip, char **args, int argc, uint8_t priority, char ground,
 									   int16_t fileDescriptors[]) {
 	return createProcess(rip, args, argc, priority, fileDescriptors, ground);
@@ -291,14 +564,8 @@ static ProcessInfo *syscall_process_info(uint16_t *processQty) {
 }
 
 static void syscall_exit() {
-	// Si STDOUT es un pipe, decrementar writers para señalar EOF
-	int16_t stdout_fd = getFd(STDOUT);
-	if (stdout_fd >= 3) {
-		closePipe(stdout_fd);
-		yield(); // Dar oportunidad al lector de despertar
-	}
-
-	killCurrentProcess();
+	// kill suelta los extremos de pipe del proceso, asi que el lector ve EOF sin que haya que cerrar nada aca
+	exitCurrentProcess();
 	yield();
 }
 
@@ -348,17 +615,117 @@ static int64_t syscall_sem_close(int id) {
 }
 
 static int64_t syscall_pipe_create() {
-	return createPipe();
+	return createPipe(getPid());
 }
 
 static int64_t syscall_pipe_read(int pipe_id, char *buffer, int size) {
-	return readPipe(pipe_id, buffer, size);
+	return readPipe(pipe_id, buffer, size, isPipeNonBlocking(pipe_id));
 }
 
 static int64_t syscall_pipe_write(int pipe_id, const char *buffer, int size) {
-	return writePipe(pipe_id, buffer, size);
+	return writePipe(pipe_id, buffer, size, isPipeNonBlocking(pipe_id));
 }
 
 static int64_t syscall_pipe_close(int pipe_id) {
 	return closePipe(pipe_id);
 }
+
+static int64_t syscall_pipe_setCapacity(int pipe_id, int capacity) {
+	return setPipeCapacity(pipe_id, capacity);
+}
+
+static int64_t syscall_pipe_open(const char *name, int end) {
+	return openProcessFifo(getCurrentProcess(), name, end);
+}
+
+static int64_t syscall_pipe_close_end(int pipe_id, int end) {
+	return closeProcessFifo(getCurrentProcess(), pipe_id, end);
+}
+
+static int64_t syscall_mq_open(const char *name, int depth, int maxSize) {
+	return openProcessQueue(getCurrentProcess(), name, depth, maxSize);
+}
+
+static int64_t syscall_mq_close(int id) {
+	return closeProcessQueue(getCurrentProcess(), id);
+}
+
+static int64_t syscall_mq_send(int id, const char *message, int length, int priority) {
+	if (!hasProcessQueue(getCurrentProcess(), id)) {
+		return -1;
+	}
+	return mqSend(id, message, length, priority);
+}
+
+static int64_t syscall_mq_receive(int id, char *buffer, int size, int *priority) {
+	if (!hasProcessQueue(getCurrentProcess(), id)) {
+		return -1;
+	}
+	return mqReceive(id, buffer, size, priority);
+}
+
+/**
+ * @brief Mueve hasta 'count' bytes de un pipe a otro pipe o a la pantalla sin pasar por userland
+ * @return Bytes movidos, 0 si el origen llego a EOF, o -1 si algun descriptor es invalido, el origen no es un pipe o
+ *         el destino no se puede escribir
+ */
+static int64_t syscall_splice(uint32_t fdIn, uint32_t fdOut, uint64_t count) {
+	int16_t realIn = getFd(fdIn);
+	int16_t realOut = getFd(fdOut);
+	if (realIn < 3 || realOut == -1 || count == 0) {
+		return -1;
+	}
+	int size = count > INT32_MAX ? INT32_MAX : (int) count;
+	int nonBlocking = isNonBlocking(fdIn) || isNonBlocking(fdOut);
+
+	if (realOut >= 3) {
+		return splicePipe(realIn, realOut, size, nonBlocking);
+	}
+	if (realOut != STDOUT && realOut != STDERR) {
+		return -1;
+	}
+
+	// el color se cambia recien con los datos en la mano: consumePipe puede bloquear mientras otros imprimen
+	return consumePipe(realIn, size, realOut == STDERR ? printErrorData : printData, nonBlocking);
+}
+
+static int64_t syscall_poll(pollfd_t *fds, uint32_t nfds, int64_t timeout) {
+	if (nfds > POLL_MAX_FDS) {
+		return -1;
+	}
+	return pollFds(fds, (int) nfds, timeout);
+}
+
+/**
+ * @brief Devuelve los flags de un descriptor: de 0 a 2 los del proceso, desde 3 los del pipe con ese id
+ */
+static int64_t syscall_get_fd_flags(uint32_t fd) {
+	if (fd < CANT_FILE_DESCRIPTORS) {
+		return getCurrentProcess()->fdFlags[fd];
+	}
+	return getPipeFlags(fd);
+}
+
+/**
+ * @brief Cambia los flags de un descriptor; por ahora el unico es FD_NONBLOCK
+ * @return 0 en caso de éxito, -1 si los flags son invalidos o el pipe no existe
+ */
+static int64_t syscall_set_fd_flags(uint32_t fd, uint32_t flags) {
+	if ((flags & ~FD_NONBLOCK) != 0) {
+		return -1;
+	}
+	if (fd < CANT_FILE_DESCRIPTORS) {
+		getCurrentProcess()->fdFlags[fd] = flags;
+		return 0;
+	}
+	return setPipeFlags(fd, flags);
+}
+
+static int isNonBlocking(uint32_t fd) {
+	return fd < CANT_FILE_DESCRIPTORS && (getCurrentProcess()->fdFlags[fd] & FD_NONBLOCK);
+}
+
+static int isPipeNonBlocking(int pipe_id) {
+	int flags = getPipeFlags(pipe_id);
+	return flags != -1 && (flags & FD_NONBLOCK);
+}
@@ -2,12 +2,14 @@
 // PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
 
 #include "include/time.h"
+#include "include/poll.h"
 #include <stdint.h>
 
 static uint64_t ticks = 0;
 
 void timerHandler() {
 	ticks++;
+	pollTick(ticks);
 }
 
 uint64_t ticksElapsed() {
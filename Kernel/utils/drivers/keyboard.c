@@ -7,6 +7,8 @@
 #include "../../include/semaphore.h"
 #include "../../include/time.h"
 #include "../../include/video.h"
+#include "../../include/waitQueue.h"
+#include <stddef.h>
 #include <stdint.h>
 
 #define BUFFER_CAPACITY 10 /* Longitud maxima del vector _buffer */
@@ -25,6 +27,7 @@ static uint8_t _buffer[BUFFER_CAPACITY] = {0}; /* Vector ciclico que guarda las
 												* que se van leyendo del teclado */
 static uint8_t _ctrl = 0;					   /* Flag para detectar si ctrl esta presionado */
 static uint8_t _shift = 0;					   /* Flag para detectar si shift esta presionado */
+static waitQueueADT _pollers = NULL;		   /* Procesos en poll esperando una tecla */
 
 static const char charHexMap[256] = /* Mapa de scancode a ASCII */
 	{0,	  0,   '1', '2', '3', '4', '5',	 '6', '7', '8', '9', '0', '-', '=', '\b', ' ', 'q', 'w', 'e',  'r', 't', 'y',
@@ -49,6 +52,7 @@ static int getBufferIndex(int offset) {
 
 void initializeKeyboardDriver() {
 	sem_create(KEYBOARD_SEM_ID, 0);
+	_pollers = createWaitQueue();
 }
 
 void keyboardHandler() {
@@ -89,6 +93,14 @@ void keyboardHandler() {
 	}
 }
 
+int pendingKeys() {
+	return _bufferSize;
+}
+
+waitQueueADT keyboardPollers() {
+	return _pollers;
+}
+
 char getScancode() {
 	if (_bufferSize > 0) {
 		char c = _buffer[getBufferIndex(0)];
@@ -121,5 +133,8 @@ static void writeKey(char key) {
 		_buffer[getBufferIndex(_bufferSize)] = key;
 		_bufferSize++;
 		sem_post(KEYBOARD_SEM_ID); // PVS falso positivo, no pasamos null pointer a la funcion, es un ID
+		if (_pollers != NULL) {
+			waitQueueWakeAll(_pollers);
+		}
 	}
 }
\ No newline at end of file
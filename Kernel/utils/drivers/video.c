@@ -268,3 +268,11 @@ void printNChars(char c, int n) {
 uint32_t getScreenResolution() {
 	return _screenData->width | _screenData->height << 16;
 }
+
+uint64_t getFramebufferAddress() {
+	return _screenData->framebuffer;
+}
+
+uint64_t getFramebufferSize() {
+	return (uint64_t) _screenData->pitch * _screenData->height;
+}
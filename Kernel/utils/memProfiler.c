@@ -0,0 +1,143 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+#include "../include/memProfiler.h"
+#include "../include/scheduler.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef MM_PROFILE
+
+#define MAX_SITES 64
+
+typedef struct sample {
+	void *ptr;
+	uint64_t size;
+	uint64_t caller;
+	int64_t pid;
+} sample_t;
+
+/*
+ * Tabla hash de direccion abierta indexada por el puntero, para que mm_free encuentre su muestra sin recorrer todo.
+ * Al borrar se corren hacia atras las muestras que siguen en la cadena, asi no hacen falta marcas de borrado y
+ * siempre quedan lugares en NULL que cortan las busquedas.
+ */
+static sample_t samples[MM_PROFILE_SAMPLES];
+static uint64_t liveSamples;
+static uint64_t allocations;
+
+static uint64_t hashPointer(void *ptr);
+static void removeSample(uint64_t index);
+
+void memProfilerAlloc(void *ptr, uint64_t size, void *caller) {
+	if (ptr == NULL || allocations++ % MM_PROFILE_RATE != 0) {
+		return;
+	}
+	// Se deja lugar libre para que las busquedas de mm_free siempre terminen
+	if (liveSamples >= MM_PROFILE_SAMPLES * 3 / 4) {
+		return;
+	}
+
+	uint64_t index = hashPointer(ptr);
+	while (samples[index].ptr != NULL) {
+		index = (index + 1) % MM_PROFILE_SAMPLES;
+	}
+	samples[index].ptr = ptr;
+	samples[index].size = size;
+	samples[index].caller = (uint64_t) caller;
+	samples[index].pid = getPid();
+	liveSamples++;
+}
+
+void memProfilerFree(void *ptr) {
+	if (liveSamples == 0) {
+		return;
+	}
+	uint64_t index = hashPointer(ptr);
+	for (uint64_t probes = 0; probes < MM_PROFILE_SAMPLES && samples[index].ptr != NULL; probes++) {
+		if (samples[index].ptr == ptr) {
+			removeSample(index);
+			liveSamples--;
+			return;
+		}
+		index = (index + 1) % MM_PROFILE_SAMPLES;
+	}
+}
+
+int64_t memProfilerTopSites(memProfileSite_t *sites, uint32_t max) {
+	static memProfileSite_t found[MAX_SITES];
+	uint32_t foundCount = 0;
+
+	for (uint64_t i = 0; i < MM_PROFILE_SAMPLES; i++) {
+		if (samples[i].ptr == NULL) {
+			continue;
+		}
+		uint32_t j = 0;
+		while (j < foundCount && (found[j].caller != samples[i].caller || found[j].pid != samples[i].pid)) {
+			j++;
+		}
+		if (j == foundCount) {
+			if (foundCount == MAX_SITES) {
+				continue;
+			}
+			found[j].caller = samples[i].caller;
+			found[j].pid = samples[i].pid;
+			found[j].liveBytes = 0;
+			found[j].samples = 0;
+			foundCount++;
+		}
+		found[j].liveBytes += samples[i].size * MM_PROFILE_RATE;
+		found[j].samples++;
+	}
+
+	// Seleccion parcial: solo hacen falta los 'max' sitios mas grandes
+	uint32_t written = 0;
+	while (written < max && written < foundCount) {
+		uint32_t biggest = written;
+		for (uint32_t j = written + 1; j < foundCount; j++) {
+			if (found[j].liveBytes > found[biggest].liveBytes) {
+				biggest = j;
+			}
+		}
+		memProfileSite_t aux = found[written];
+		found[written] = found[biggest];
+		found[biggest] = aux;
+		sites[written] = found[written];
+		written++;
+	}
+	return written;
+}
+
+static uint64_t hashPointer(void *ptr) {
+	// Dos bloques distintos estan separados por al menos 16 bytes, los bits bajos no aportan
+	return (((uint64_t) ptr >> 4) * 0x9E3779B97F4A7C15ULL >> 32) % MM_PROFILE_SAMPLES;
+}
+
+/**
+ * @brief Vacia un lugar y corre hacia atras las muestras de la cadena que quedarian inalcanzables desde su hash
+ */
+static void removeSample(uint64_t index) {
+	uint64_t next = index;
+	while (1) {
+		next = (next + 1) % MM_PROFILE_SAMPLES;
+		if (samples[next].ptr == NULL) {
+			break;
+		}
+		// Se queda donde esta si su hash cae entre el hueco (exclusive) y su lugar actual (inclusive)
+		uint64_t home = hashPointer(samples[next].ptr);
+		int reachable = index <= next ? (index < home && home <= next) : (index < home || home <= next);
+		if (!reachable) {
+			samples[index] = samples[next];
+			index = next;
+		}
+	}
+	samples[index].ptr = NULL;
+}
+
+#else
+
+int64_t memProfilerTopSites(memProfileSite_t *sites, uint32_t max) {
+	return -1;
+}
+
+#endif
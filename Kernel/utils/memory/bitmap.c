@@ -1,7 +1,9 @@
 // This is a personal academic project. Dear PVS-Studio, please check it.
 // PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
 
+#include "../../include/memProfiler.h"
 #include "../../include/memoryManagement.h"
+#include "../../include/memoryPressure.h"
 #include <stdint.h>
 #include <string.h>
 
@@ -10,18 +12,33 @@
 #define BORDER 2
 #define BLOCK_SIZE 64
 #define BYTE_SIZE 8
+#define ALIGN_UP(x, a) (((x) + (a) - 1) & ~((uint64_t) (a) - 1))
+#define TOUCH_CHUNK 4096 // Entradas del bitmap que se inicializan de una vez al avanzar la marca
 
 typedef struct MemoryManagerCDT {
 	uint8_t *bitmap;
+	uint16_t *lengths; // Cantidad de bloques de cada asignacion, indexada por su bloque BORDER
 	void *realMemStart;
 	uint64_t blockCount;
 	uint64_t usedBlocksCount;
+	uint64_t touchedBlocks; // Entradas inicializadas; las siguientes se consideran FREE sin haberse escrito
+
+	uint64_t peakBlocks;
+	uint64_t requestedBytes;
+	uint64_t grantedBytes;
+	uint64_t allocCount;
+	uint64_t freeCount;
+	uint64_t failedCount;
 } MemoryManagerCDT;
 
 typedef struct MemoryManagerCDT *MemoryManagerADT;
 
 static void *memoryBaseAddress;
 
+static void *allocBlocks(MemoryManagerADT manager, uint64_t blocksNeeded);
+static uint8_t getBucket(uint64_t bytes);
+static void touchBlocks(MemoryManagerADT manager);
+
 MemoryManagerADT mm_create(void *const restrict startAddress, uint64_t totalSize) {
 	memoryBaseAddress = startAddress;
 	MemoryManagerADT manager = (MemoryManagerADT) memoryBaseAddress;
@@ -31,21 +48,27 @@ MemoryManagerADT mm_create(void *const restrict startAddress, uint64_t totalSize
 		return NULL;
 	}
 
-	manager->blockCount = (totalSize - structSize) / (BLOCK_SIZE + 1);
+	// Cada bloque lleva su byte de estado y una entrada de la tabla de largos (mm_alloc no pasa de MM_MAX_ALLOC)
+	manager->blockCount = (totalSize - structSize - sizeof(uint16_t)) / (BLOCK_SIZE + 1 + sizeof(uint16_t));
 	if (manager->blockCount == 0) {
 		return NULL;
 	}
 	manager->usedBlocksCount = 0;
+	manager->touchedBlocks = 0;
+	manager->peakBlocks = 0;
+	manager->requestedBytes = 0;
+	manager->grantedBytes = 0;
+	manager->allocCount = 0;
+	manager->failedCount = 0;
+	manager->freeCount = 0;
 	manager->bitmap =
 		(uint8_t *) memoryBaseAddress + structSize; // El bitmap arranca después del espacio asignado al struct
+	manager->lengths = (uint16_t *) ALIGN_UP((uintptr_t) (manager->bitmap + manager->blockCount), sizeof(uint16_t));
 	manager->realMemStart =
-		(void *) ((uint8_t *) manager->bitmap +
-				  manager->blockCount); // El espacio de memoria "usable" arranca después del espacio asignado al bitmap
-
-	for (uint64_t i = 0; i < manager->blockCount; i++) {
-		manager->bitmap[i] = FREE;
-	}
+		(void *) (manager->lengths +
+				  manager->blockCount); // El espacio de memoria "usable" arranca después de la tabla de largos
 
+	// El bitmap no se recorre aca: se inicializa por tramos a medida que mm_alloc llega a la zona sin usar
 	return manager;
 }
 
@@ -55,26 +78,52 @@ static MemoryManagerADT getMemoryManager(void) {
 
 void *mm_alloc(const size_t bytes) {
 	MemoryManagerADT manager = getMemoryManager();
-	if (manager == NULL || bytes == 0 || bytes > POW2(17)) {
+	if (manager == NULL || bytes == 0) {
 		return NULL;
 	}
 
 	uint64_t blocksNeeded = (bytes + (BLOCK_SIZE - 1)) / BLOCK_SIZE;
-	if (blocksNeeded > (manager->blockCount - manager->usedBlocksCount)) {
+	if (bytes > MM_MAX_ALLOC) {
+		manager->failedCount++;
+		return NULL;
+	}
+
+	void *result = NULL;
+	do {
+		if (blocksNeeded <= (manager->blockCount - manager->usedBlocksCount)) {
+			result = allocBlocks(manager, blocksNeeded);
+		}
+	} while (result == NULL && MM_RECLAIM(bytes));
+
+	if (result == NULL) {
+		manager->failedCount++;
 		return NULL;
 	}
 
+	manager->allocCount++;
+	manager->requestedBytes += bytes;
+	manager->grantedBytes += blocksNeeded * BLOCK_SIZE;
+	if (manager->usedBlocksCount > manager->peakBlocks) {
+		manager->peakBlocks = manager->usedBlocksCount;
+	}
+	MM_PROFILE_ALLOC(result, bytes);
+	return result;
+}
+
+static void *allocBlocks(MemoryManagerADT manager, uint64_t blocksNeeded) {
 	uint64_t freeBlocks = 0;
 	for (uint64_t i = 0; i < manager->blockCount; i++) {
+		if (i == manager->touchedBlocks) {
+			touchBlocks(manager);
+		}
 		if (manager->bitmap[i] == FREE) {
 			freeBlocks++;
 			if (freeBlocks == blocksNeeded) {
 				uint64_t start = i - freeBlocks + 1;
 
 				manager->bitmap[start] = BORDER;
-				for (uint64_t j = start + 1; j <= i; j++) {
-					manager->bitmap[j] = USED;
-				}
+				memset(manager->bitmap + start + 1, USED, blocksNeeded - 1);
+				manager->lengths[start] = (uint16_t) blocksNeeded;
 
 				manager->usedBlocksCount += blocksNeeded;
 
@@ -99,20 +148,19 @@ void mm_free(void *const restrict ptr) {
 	}
 
 	uint64_t index = ((uint8_t *) ptr - (uint8_t *) manager->realMemStart) / BLOCK_SIZE;
-	if (index >= manager->blockCount) {
+	if (index >= manager->touchedBlocks) {
 		return;
 	}
 	if (manager->bitmap[index] != BORDER) {
 		return;
 	}
 
-	manager->bitmap[index] = FREE;
-	manager->usedBlocksCount--;
-
-	for (uint64_t i = index + 1; i < manager->blockCount && manager->bitmap[i] == USED; i++) {
-		manager->bitmap[i] = FREE;
-		manager->usedBlocksCount--;
-	}
+	// El largo sale de la tabla, sin recorrer el bitmap buscando el final del bloque
+	uint64_t length = manager->lengths[index];
+	memset(manager->bitmap + index, FREE, length);
+	manager->usedBlocksCount -= length;
+	manager->freeCount++;
+	MM_PROFILE_FREE(ptr);
 }
 
 mem_t mm_info(void) {
@@ -121,8 +169,67 @@ mem_t mm_info(void) {
 	if (manager == NULL) {
 		return info;
 	}
-	info.size = manager->blockCount;
-	info.used = manager->usedBlocksCount;
+	info.size = manager->blockCount * BLOCK_SIZE;
+	info.used = manager->usedBlocksCount * BLOCK_SIZE;
 	info.free = info.size - info.used;
 	return info;
 }
+
+void mm_stats(mm_stats_t *stats) {
+	MemoryManagerADT manager = getMemoryManager();
+	memset(stats, 0, sizeof(mm_stats_t));
+	if (manager == NULL) {
+		return;
+	}
+
+	stats->size = manager->blockCount * BLOCK_SIZE;
+	stats->used = manager->usedBlocksCount * BLOCK_SIZE;
+	stats->free = stats->size - stats->used;
+	stats->peakUsed = manager->peakBlocks * BLOCK_SIZE;
+	stats->requestedBytes = manager->requestedBytes;
+	stats->grantedBytes = manager->grantedBytes;
+	stats->allocCount = manager->allocCount;
+	stats->freeCount = manager->freeCount;
+	stats->failedCount = manager->failedCount;
+
+	// cada racha de bloques FREE consecutivos es un hueco que puede atender un pedido; la zona sin tocar es libre
+	uint64_t run = 0;
+	for (uint64_t i = 0; i <= manager->touchedBlocks; i++) {
+		if (i < manager->touchedBlocks && manager->bitmap[i] == FREE) {
+			run++;
+			continue;
+		}
+		if (i == manager->touchedBlocks) {
+			run += manager->blockCount - manager->touchedBlocks;
+		}
+		if (run > 0) {
+			uint64_t bytes = run * BLOCK_SIZE;
+			stats->freeBlocks[getBucket(bytes)]++;
+			if (bytes > stats->largestFreeBlock) {
+				stats->largestFreeBlock = bytes;
+			}
+			run = 0;
+		}
+	}
+}
+
+static uint8_t getBucket(uint64_t bytes) {
+	uint8_t bucket = 0;
+	while (bytes > 1 && bucket < MM_STATS_BUCKETS - 1) {
+		bytes >>= 1;
+		bucket++;
+	}
+	return bucket;
+}
+
+/**
+ * @brief Marca como FREE el siguiente tramo del bitmap que todavia no fue usado
+ */
+static void touchBlocks(MemoryManagerADT manager) {
+	uint64_t count = manager->blockCount - manager->touchedBlocks;
+	if (count > TOUCH_CHUNK) {
+		count = TOUCH_CHUNK;
+	}
+	memset(manager->bitmap + manager->touchedBlocks, FREE, count);
+	manager->touchedBlocks += count;
+}
@@ -1,72 +1,112 @@
 // This is a personal academic project. Dear PVS-Studio, please check it.
 // PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
 
+#include "../../include/memProfiler.h"
 #include "../../include/memoryManagement.h"
+#include "../../include/memoryPressure.h"
+#include <string.h>
 
 #define FREE 0
 #define USED 1
 #define SPLIT 2
 #define MIN_EXP 4
-#define MAX_EXP 28
+#define MAX_EXP 32
 
-typedef struct Node {
-	uint8_t state;
-} Node;
-
-typedef struct Node *TNode;
+/*
+ * Cada nodo guarda su estado en 2 bits, 32 nodos por palabra, en el mismo orden que el heap implicito (hijos en
+ * 2n+1 y 2n+2). Los primeros 8 niveles entran en una sola linea de cache y cada nivel ocupa un tramo contiguo.
+ */
+#define STATE_BITS 2
+#define STATE_MASK 0x3
+#define STATES_PER_WORD (64 / STATE_BITS)
+#define CACHE_LINE 64
+#define ORDER_MASK 0xF // mm_alloc no pasa de MM_MAX_ALLOC = 2^17 bytes, asi que (exponente - MIN_EXP) entra en 4 bits
+#define ALIGN_UP(x, a) (((x) + (a) - 1) & ~((uint64_t) (a) - 1))
 
 typedef struct MemoryManagerCDT {
 	uint8_t *treeStart;
-	TNode tree;
+	uint64_t *tree;
 	uint64_t size;
 	uint64_t used;
 	uint8_t maxExp;
 	uint64_t totalNodes;
+	uint8_t *orders; // exponente de cada asignacion (menos MIN_EXP) en 4 bits, indexado por su bloque minimo inicial
+
+	uint64_t peakUsed;
+	uint64_t requestedBytes;
+	uint64_t grantedBytes;
+	uint64_t allocCount;
+	uint64_t freeCount;
+	uint64_t failedCount;
 } MemoryManagerCDT;
 
 static MemoryManagerADT memoryBaseAddress = NULL;
 
+static int64_t allocNode(MemoryManagerADT manager, uint8_t exponent);
 static int64_t getNodeIndex(uint8_t *ptr, uint8_t *exponent);
-static uint8_t getExponentPtr(void *memoryToFree);
 static uint8_t getExponent(uint64_t size);
 static int64_t findFreeNode(uint64_t node, uint8_t level, uint8_t targetLevel);
 static uint64_t getNodeLevel(uint8_t exponent);
 static void setMerge(uint64_t node);
 static void splitTree(uint64_t node);
 static void setSplitedChildren(uint64_t node);
+static void collectFreeBlocks(mm_stats_t *stats, uint64_t node, uint8_t exponent, uint64_t offset);
+static uint8_t getBucket(uint64_t bytes);
+static uint8_t getOrder(uint64_t offset);
+static void setOrder(uint64_t offset, uint8_t exponent);
+static uint8_t getState(uint64_t node);
+static void setState(uint64_t node, uint8_t state);
 
 MemoryManagerADT mm_create(void *const restrict startAddress, uint64_t totalSize) {
 	if (totalSize < POW2(MIN_EXP)) {
 		return NULL;
 	}
 
+	/* el arbol cubre la menor potencia de 2 que contiene a toda la region; la cola sin memoria real nunca se asigna */
 	uint8_t computedMax = MIN_EXP;
-	while (((uint64_t) 1 << (computedMax + 1)) <= (totalSize) && computedMax < MAX_EXP) {
+	while (((uint64_t) 1 << computedMax) < totalSize && computedMax < MAX_EXP) {
 		computedMax++;
 	}
 
 	uint64_t nodes = ((uint64_t) 1 << (computedMax - MIN_EXP + 1)) - 1;
 
-	uint64_t needed = sizeof(MemoryManagerCDT) + (nodes * sizeof(Node)) + POW2(MIN_EXP);
-	if (totalSize < needed) {
+	/* el arbol arranca alineado a una linea de cache y ocupa lineas completas */
+	uint8_t *base = (uint8_t *) startAddress;
+	uint64_t treeOffset = ALIGN_UP((uintptr_t) base + sizeof(MemoryManagerCDT), CACHE_LINE) - (uintptr_t) base;
+	uint64_t treeBytes = ALIGN_UP((nodes + STATES_PER_WORD - 1) / STATES_PER_WORD * sizeof(uint64_t), CACHE_LINE);
+	if (totalSize < treeOffset + treeBytes + POW2(MIN_EXP)) {
+		return NULL;
+	}
+	/* medio byte por cada bloque minimo de lo que queda despues del arbol */
+	uint64_t orderBytes = ALIGN_UP((totalSize - treeOffset - treeBytes) >> (MIN_EXP + 1), CACHE_LINE);
+	uint64_t metadata = treeOffset + treeBytes + orderBytes;
+	if (totalSize < metadata + POW2(MIN_EXP)) {
 		return NULL;
 	}
 
-	uint8_t *base = (uint8_t *) startAddress;
 	memoryBaseAddress = (MemoryManagerADT) base;
 	MemoryManagerADT manager = (MemoryManagerADT) memoryBaseAddress;
 
 	manager->maxExp = computedMax;
 	manager->totalNodes = nodes;
-	manager->tree = (TNode) (base + sizeof(MemoryManagerCDT));
-	manager->treeStart = base + sizeof(MemoryManagerCDT) + (nodes * sizeof(Node));
+	manager->tree = (uint64_t *) (base + treeOffset);
+	manager->orders = base + treeOffset + treeBytes;
+	manager->treeStart = base + metadata;
 
-	manager->size = totalSize - (sizeof(MemoryManagerCDT) + (nodes * sizeof(Node)));
+	manager->size = totalSize - metadata;
+	if (manager->size > POW2(computedMax)) {
+		manager->size = POW2(computedMax);
+	}
 	manager->used = 0;
+	manager->peakUsed = 0;
+	manager->requestedBytes = 0;
+	manager->grantedBytes = 0;
+	manager->allocCount = 0;
+	manager->freeCount = 0;
+	manager->failedCount = 0;
 
-	for (uint64_t i = 0; i < manager->totalNodes; i++) {
-		manager->tree[i].state = FREE;
-	}
+	/* solo la raiz arranca inicializada; cada nodo se escribe la primera vez que se parte su padre */
+	setState(0, FREE);
 
 	return manager;
 }
@@ -77,21 +117,52 @@ static MemoryManagerADT getMemoryManager(void) {
 
 void *mm_alloc(size_t size) {
 	MemoryManagerADT manager = getMemoryManager();
-	if (size > manager->size - manager->used || size == 0 || size > POW2(17)) {
+	if (size == 0 || size > MM_MAX_ALLOC) {
+		manager->failedCount++;
 		return NULL;
 	}
 	uint8_t exponent = getExponent(size);
-	int64_t nodo = findFreeNode(0, 0, manager->maxExp - exponent);
-	if (nodo == -1)
+	int64_t offset;
+	do {
+		offset = allocNode(manager, exponent);
+	} while (offset == -1 && MM_RECLAIM(size));
+	if (offset == -1) {
+		manager->failedCount++;
 		return NULL;
+	}
+	manager->allocCount++;
+	manager->requestedBytes += size;
+	manager->grantedBytes += POW2(exponent);
+	if (manager->used > manager->peakUsed) {
+		manager->peakUsed = manager->used;
+	}
+	MM_PROFILE_ALLOC(manager->treeStart + offset, size);
+	return (void *) (manager->treeStart + offset);
+}
+
+/**
+ * @brief Reserva un bloque de 2^exponent bytes en el arbol
+ * @return Offset del bloque dentro del heap, o -1 si no hay uno libre
+ */
+static int64_t allocNode(MemoryManagerADT manager, uint8_t exponent) {
+	if (POW2(exponent) > manager->size - manager->used) {
+		return -1;
+	}
+	int64_t nodo = findFreeNode(0, 0, manager->maxExp - exponent);
+	if (nodo == -1) {
+		return -1;
+	}
+	uint64_t offset = (uint64_t) (nodo - getNodeLevel(exponent)) * POW2(exponent);
+	if (offset + POW2(exponent) > manager->size) {
+		// El nodo cae en la cola del arbol que no tiene memoria real detras
+		setMerge(nodo);
+		return -1;
+	}
 	splitTree(nodo);
 	setSplitedChildren(nodo);
+	setOrder(offset, exponent);
 	manager->used += POW2(exponent);
-	uint64_t offset = (uint64_t) (nodo - getNodeLevel(exponent)) * POW2(exponent);
-	if (offset >= manager->size) {
-		return NULL;
-	}
-	return (void *) (manager->treeStart + offset);
+	return (int64_t) offset;
 }
 
 void mm_free(void *const restrict memoryToFree) {
@@ -99,47 +170,35 @@ void mm_free(void *const restrict memoryToFree) {
 	if (memoryToFree == NULL) {
 		return;
 	}
-	uint8_t exponent = getExponentPtr(memoryToFree);
+	uint8_t exponent;
 	int64_t nodo = getNodeIndex((uint8_t *) memoryToFree, &exponent);
 	if (nodo < 0)
 		return;
-	manager->tree[nodo].state = FREE;
+	setState(nodo, FREE);
 	setMerge(nodo);
 	manager->used -= POW2(exponent);
+	manager->freeCount++;
+	MM_PROFILE_FREE(memoryToFree);
 }
 
 static int64_t getNodeIndex(uint8_t *ptr, uint8_t *exponent) {
 	MemoryManagerADT manager = getMemoryManager();
-	int64_t node = 0;
-	uint8_t levelExponent = *exponent;
-	while (levelExponent > 0 && manager->tree[node].state != USED) {
-		/* compute offset in bytes from treeStart, then shift by levelExponent */
-		if ((uintptr_t) ptr < (uintptr_t) manager->treeStart)
-			return -1;
-		uint64_t offset = (uint64_t) ((uintptr_t) ptr - (uintptr_t) manager->treeStart);
-		if (offset >= manager->size)
-			return -1;
-		node = (int64_t) ((offset >> levelExponent) + getNodeLevel(levelExponent));
-		levelExponent--;
-	}
+	if ((uintptr_t) ptr < (uintptr_t) manager->treeStart)
+		return -1;
+	uint64_t offset = (uint64_t) ((uintptr_t) ptr - (uintptr_t) manager->treeStart);
+	if (offset >= manager->size || offset % POW2(MIN_EXP) != 0)
+		return -1;
+	/* la tabla de ordenes da el tamaño del bloque directamente; el arbol solo confirma que sigue asignado */
+	uint8_t levelExponent = getOrder(offset);
+	if (levelExponent > manager->maxExp || offset % POW2(levelExponent) != 0)
+		return -1;
+	int64_t node = (int64_t) ((offset >> levelExponent) + getNodeLevel(levelExponent));
+	if (getState(node) != USED)
+		return -1;
 	*exponent = levelExponent;
 	return node;
 }
 
-static uint8_t getExponentPtr(void *memoryToFree) {
-	MemoryManagerADT manager = getMemoryManager();
-	if ((uintptr_t) memoryToFree < (uintptr_t) manager->treeStart)
-		return 0;
-	uint64_t address = (uint64_t) ((uintptr_t) memoryToFree - (uintptr_t) manager->treeStart);
-	uint8_t exponent = manager->maxExp;
-	uint64_t size = POW2(manager->maxExp);
-	while (address % size != 0) {
-		exponent--;
-		size >>= 1;
-	}
-	return exponent;
-}
-
 static uint8_t getExponent(uint64_t size) {
 	uint8_t exponent = MIN_EXP;
 	uint64_t pot = (uint64_t) 1 << MIN_EXP;
@@ -152,19 +211,33 @@ static uint8_t getExponent(uint64_t size) {
 	return exponent;
 }
 static int64_t findFreeNode(uint64_t node, uint8_t level, uint8_t targetLevel) {
-	MemoryManagerADT manager = getMemoryManager();
-	if (level == targetLevel) {
-		if (manager->tree[node].state == FREE)
+	/* recorrido en profundidad sin recursion: se baja por los nodos partidos y se retrocede por los ocupados */
+	while (1) {
+		uint8_t state = getState(node);
+		if (state == FREE) {
+			/* los hijos de un nodo libre no estan inicializados: se parte el camino mas a la izquierda recien ahora */
+			while (level < targetLevel) {
+				setState(node, SPLIT);
+				setState(node * 2 + 2, FREE);
+				node = node * 2 + 1;
+				level++;
+			}
+			setState(node, FREE);
 			return node;
-		else
+		}
+		if (state == SPLIT && level < targetLevel) {
+			node = node * 2 + 1;
+			level++;
+			continue;
+		}
+		while (node != 0 && node % 2 == 0) {
+			node = (node - 1) / 2;
+			level--;
+		}
+		if (node == 0)
 			return -1;
+		node++;
 	}
-	if (manager->tree[node].state != SPLIT && manager->tree[node].state != FREE)
-		return -1;
-	int64_t left = findFreeNode(node * 2 + 1, level + 1, targetLevel);
-	if (left != -1)
-		return left;
-	return findFreeNode(node * 2 + 2, level + 1, targetLevel);
 }
 
 static uint64_t getNodeLevel(uint8_t exponent) {
@@ -189,27 +262,26 @@ static void setMerge(uint64_t node) {
 			return;
 	}
 
-	if (buddy < manager->totalNodes && manager->tree[buddy].state == FREE && manager->tree[node].state == FREE) {
+	if (buddy < manager->totalNodes && getState(buddy) == FREE && getState(node) == FREE) {
 		uint64_t parent = (node - 1) / 2;
-		if (parent < manager->totalNodes && manager->tree[parent].state == SPLIT) {
-			manager->tree[parent].state = FREE;
+		if (parent < manager->totalNodes && getState(parent) == SPLIT) {
+			setState(parent, FREE);
 			setMerge(parent);
 		}
 	}
 }
 
 static void splitTree(uint64_t node) {
-	MemoryManagerADT manager = getMemoryManager();
 	while (node) {
 		node = (node - 1) / 2;
-		manager->tree[node].state = SPLIT;
+		setState(node, SPLIT);
 	}
 }
 
 static void setSplitedChildren(uint64_t node) {
 	MemoryManagerADT manager = getMemoryManager();
 	if (node < manager->totalNodes) {
-		manager->tree[node].state = USED;
+		setState(node, USED);
 	}
 }
 
@@ -224,3 +296,84 @@ mem_t mm_info(void) {
 	info.free = manager->size - manager->used;
 	return info;
 }
+
+void mm_stats(mm_stats_t *stats) {
+	MemoryManagerADT manager = getMemoryManager();
+	memset(stats, 0, sizeof(mm_stats_t));
+	if (manager == NULL) {
+		return;
+	}
+
+	stats->size = manager->size;
+	stats->used = manager->used;
+	stats->free = manager->size - manager->used;
+	stats->peakUsed = manager->peakUsed;
+	stats->requestedBytes = manager->requestedBytes;
+	stats->grantedBytes = manager->grantedBytes;
+	stats->allocCount = manager->allocCount;
+	stats->freeCount = manager->freeCount;
+	stats->failedCount = manager->failedCount;
+
+	collectFreeBlocks(stats, 0, manager->maxExp, 0);
+}
+
+/**
+ * @brief Recorre el arbol bajando solo por los nodos partidos y cuenta cada nodo libre como un bloque
+ * @note  Los bloques que se salen de la memoria real se recortan a lo que efectivamente existe
+ */
+static void collectFreeBlocks(mm_stats_t *stats, uint64_t node, uint8_t exponent, uint64_t offset) {
+	MemoryManagerADT manager = getMemoryManager();
+	if (node >= manager->totalNodes || offset >= manager->size) {
+		return;
+	}
+
+	if (getState(node) == SPLIT) {
+		collectFreeBlocks(stats, node * 2 + 1, exponent - 1, offset);
+		collectFreeBlocks(stats, node * 2 + 2, exponent - 1, offset + POW2(exponent - 1));
+		return;
+	}
+
+	if (getState(node) == FREE) {
+		uint64_t bytes = POW2(exponent);
+		if (offset + bytes > manager->size) {
+			bytes = manager->size - offset;
+		}
+		stats->freeBlocks[getBucket(bytes)]++;
+		if (bytes > stats->largestFreeBlock) {
+			stats->largestFreeBlock = bytes;
+		}
+	}
+}
+
+static uint8_t getBucket(uint64_t bytes) {
+	uint8_t bucket = 0;
+	while (bytes > 1 && bucket < MM_STATS_BUCKETS - 1) {
+		bytes >>= 1;
+		bucket++;
+	}
+	return bucket;
+}
+
+static uint8_t getState(uint64_t node) {
+	uint64_t word = getMemoryManager()->tree[node / STATES_PER_WORD];
+	return (uint8_t) ((word >> ((node % STATES_PER_WORD) * STATE_BITS)) & STATE_MASK);
+}
+
+static void setState(uint64_t node, uint8_t state) {
+	uint64_t *word = &getMemoryManager()->tree[node / STATES_PER_WORD];
+	uint8_t shift = (node % STATES_PER_WORD) * STATE_BITS;
+	*word = (*word & ~((uint64_t) STATE_MASK << shift)) | ((uint64_t) state << shift);
+}
+
+static uint8_t getOrder(uint64_t offset) {
+	uint64_t block = offset >> MIN_EXP;
+	uint8_t entry = getMemoryManager()->orders[block / 2];
+	return MIN_EXP + ((block % 2) ? (entry >> 4) : (entry & ORDER_MASK));
+}
+
+static void setOrder(uint64_t offset, uint8_t exponent) {
+	uint64_t block = offset >> MIN_EXP;
+	uint8_t *entry = &getMemoryManager()->orders[block / 2];
+	uint8_t shift = (block % 2) * 4;
+	*entry = (uint8_t) ((*entry & ~(ORDER_MASK << shift)) | ((exponent - MIN_EXP) << shift));
+}
@@ -0,0 +1,80 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+#include "../include/memoryPressure.h"
+#include "../include/memoryManagement.h"
+#include "../include/scheduler.h"
+#include "../include/semaphore.h"
+#include "../include/video.h"
+#include <stddef.h>
+#include <stdint.h>
+
+static void *reserve = NULL;
+static int criticalDepth = 0;
+static int refilling = 0;	// mientras se reaparta la reserva un pedido que falla no es falta de memoria
+static int oomPending = 0; // algun pedido no critico se quedo sin memoria
+
+void initMemoryPressure() {
+	reserve = NULL;
+	criticalDepth = 0;
+	refilling = 0;
+	oomPending = 0;
+	refillMemoryReserve();
+}
+
+int memoryPressureReclaim(uint64_t size) {
+	if (refilling) {
+		return 0;
+	}
+
+	// Lo primero que se suelta es lo que el kernel guarda sin que nadie lo vaya a usar
+	if (sem_purgeWaiters() > 0) {
+		return 1;
+	}
+
+	if (criticalDepth > 0 && reserve != NULL && size <= MM_RESERVE_SIZE) {
+		mm_free(reserve);
+		reserve = NULL;
+		return 1;
+	}
+
+	// Un pedido grande puede fallar solo porque el heap esta fragmentado; eso no justifica matar a nadie
+	if (criticalDepth == 0 && mm_info().free < size + MM_LOW_WATER) {
+		oomPending = 1;
+	}
+	return 0;
+}
+
+void beginCriticalAllocation() {
+	criticalDepth++;
+}
+
+void endCriticalAllocation() {
+	if (criticalDepth > 0) {
+		criticalDepth--;
+	}
+}
+
+void handleMemoryPressure() {
+	if (!oomPending) {
+		return;
+	}
+	oomPending = 0;
+
+	int16_t victim = findLargestProcess();
+	if (victim == -1) {
+		return;
+	}
+	ProcessContext *process = findProcess(victim);
+	printf("Sin memoria: se termina el proceso %d (%s)\n", victim, process->name != NULL ? process->name : "?");
+	killProcess(victim);
+}
+
+void refillMemoryReserve() {
+	if (reserve != NULL) {
+		return;
+	}
+	refilling = 1;
+	reserve = mm_alloc(MM_RESERVE_SIZE);
+	refilling = 0;
+}
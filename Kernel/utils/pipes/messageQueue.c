@@ -0,0 +1,229 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+#include "../../include/messageQueue.h"
+#include "../../include/lib.h"
+#include "../../include/memoryManagement.h"
+#include "../../include/objectTable.h"
+#include "../../include/semaphore.h"
+#include <stddef.h>
+
+static objectTable_t table; // el id de cada cola es su lugar en la tabla
+
+static mqueue_t *findQueue(int id);
+static int findNamedQueue(const char *name);
+static int newQueue(const char *name, int length, int depth, int maxSize);
+static void destroyQueue(mqueue_t *queue);
+
+void initializeMessageQueues() {
+	initializeObjectTable(&table, MQ_TABLE_INITIAL_SIZE, MQ_MAX_ID);
+}
+
+int mqOpen(const char *name, int depth, int maxSize) {
+	if (name == NULL || name[0] == '\0') {
+		return -1;
+	}
+	int length = 0;
+	while (name[length] != '\0') {
+		if (++length == MQ_NAME_LENGTH) {
+			return -1;
+		}
+	}
+
+	int id = findNamedQueue(name);
+	if (id == -1) {
+		if (depth <= 0 || depth > MQ_MAX_DEPTH || maxSize <= 0 || maxSize > MQ_MAX_MESSAGE) {
+			return -1;
+		}
+		id = newQueue(name, length, depth, maxSize);
+		if (id == -1) {
+			return -1;
+		}
+	}
+
+	mqRetain(id);
+	return id;
+}
+
+int mqRetain(int id) {
+	mqueue_t *queue = findQueue(id);
+	if (queue == NULL) {
+		return -1;
+	}
+
+	acquire(&queue->lock);
+	queue->refs++;
+	release(&queue->lock);
+	return 0;
+}
+
+int mqClose(int id) {
+	mqueue_t *queue = findQueue(id);
+	if (queue == NULL) {
+		return -1;
+	}
+
+	acquire(&queue->lock);
+	if (--queue->refs > 0) {
+		release(&queue->lock);
+		return 0;
+	}
+	// Si alguien esperaba sin haberla abierto, al despertar ve que la cola ya no existe
+	waitQueueWakeAll(queue->receivers);
+	waitQueueWakeAll(queue->senders);
+	release(&queue->lock);
+	objectTableRemove(&table, id);
+	destroyQueue(queue);
+	return 0;
+}
+
+void mqCancel(int id, int16_t pid) {
+	mqueue_t *queue = findQueue(id);
+	if (queue == NULL) {
+		return;
+	}
+
+	acquire(&queue->lock);
+	waitQueueRemove(queue->receivers, pid);
+	waitQueueRemove(queue->senders, pid);
+	release(&queue->lock);
+}
+
+int mqSend(int id, const char *message, int length, int priority) {
+	mqueue_t *queue = findQueue(id);
+	if (queue == NULL || (message == NULL && length > 0) || length < 0 || priority < 0 || priority >= MQ_PRIORITIES) {
+		return -1;
+	}
+
+	acquire(&queue->lock);
+	if (length > queue->maxSize) {
+		release(&queue->lock);
+		return -1;
+	}
+	while (queue->freeSlots == -1) {
+		queue = objectTableSleep(&table, id, queue->senders, &queue->lock);
+		if (queue == NULL) {
+			return -1;
+		}
+	}
+
+	int16_t slot = queue->freeSlots;
+	queue->freeSlots = queue->slots[slot].next;
+	queue->slots[slot].next = -1;
+	queue->slots[slot].length = length;
+	memcpy(queue->data + slot * queue->maxSize, message, length);
+
+	// Dentro de cada prioridad los mensajes salen en el orden en que llegaron
+	if (queue->tail[priority] == -1) {
+		queue->head[priority] = slot;
+	}
+	else {
+		queue->slots[queue->tail[priority]].next = slot;
+	}
+	queue->tail[priority] = slot;
+	queue->count++;
+
+	waitQueueWakeAll(queue->receivers);
+	release(&queue->lock);
+	return 0;
+}
+
+int mqReceive(int id, char *buffer, int size, int *priority) {
+	mqueue_t *queue = findQueue(id);
+	if (queue == NULL || buffer == NULL || size < 0) {
+		return -1;
+	}
+
+	acquire(&queue->lock);
+	while (queue->count == 0) {
+		queue = objectTableSleep(&table, id, queue->receivers, &queue->lock);
+		if (queue == NULL) {
+			return -1;
+		}
+	}
+
+	int level = MQ_PRIORITIES - 1;
+	while (queue->head[level] == -1) {
+		level--;
+	}
+	int16_t slot = queue->head[level];
+	int length = queue->slots[slot].length;
+	if (length > size) {
+		release(&queue->lock);
+		return -1;
+	}
+	memcpy(buffer, queue->data + slot * queue->maxSize, length);
+	if (priority != NULL) {
+		*priority = level;
+	}
+
+	queue->head[level] = queue->slots[slot].next;
+	if (queue->head[level] == -1) {
+		queue->tail[level] = -1;
+	}
+	queue->slots[slot].next = queue->freeSlots;
+	queue->freeSlots = slot;
+	queue->count--;
+
+	waitQueueWakeAll(queue->senders);
+	release(&queue->lock);
+	return length;
+}
+
+static mqueue_t *findQueue(int id) {
+	return objectTableGet(&table, id);
+}
+
+static int findNamedQueue(const char *name) {
+	for (int i = 0; i < table.size; i++) {
+		mqueue_t *queue = objectTableGet(&table, i);
+		if (queue != NULL && strcmp(queue->name, name) == 0) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+/**
+ * @brief Crea una cola vacia, sin aperturas, en el primer lugar libre de la tabla
+ * @return ID de la cola o -1 si no hay memoria
+ */
+static int newQueue(const char *name, int length, int depth, int maxSize) {
+	mqueue_t *queue = mm_alloc(sizeof(mqueue_t));
+	if (queue == NULL) {
+		return -1;
+	}
+	memset(queue, 0, sizeof(mqueue_t));
+	queue->slots = mm_alloc(depth * sizeof(mqSlot_t));
+	queue->data = mm_alloc(depth * maxSize);
+	queue->receivers = createWaitQueue();
+	queue->senders = createWaitQueue();
+	if (queue->slots == NULL || queue->data == NULL || queue->receivers == NULL || queue->senders == NULL) {
+		destroyQueue(queue);
+		return -1;
+	}
+
+	memcpy(queue->name, name, length + 1);
+	queue->depth = depth;
+	queue->maxSize = maxSize;
+	for (int i = 0; i < MQ_PRIORITIES; i++) {
+		queue->head[i] = queue->tail[i] = -1;
+	}
+	for (int i = 0; i < depth; i++) {
+		queue->slots[i].next = i + 1 < depth ? i + 1 : -1;
+	}
+	queue->freeSlots = 0;
+	int id = objectTableAdd(&table, queue);
+	if (id == -1) {
+		destroyQueue(queue);
+	}
+	return id;
+}
+
+static void destroyQueue(mqueue_t *queue) {
+	freeWaitQueue(queue->receivers);
+	freeWaitQueue(queue->senders);
+	mm_free(queue->slots);
+	mm_free(queue->data);
+	mm_free(queue);
+}
@@ -0,0 +1,88 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+#include "../../include/objectTable.h"
+#include "../../include/lib.h"
+#include "../../include/memoryManagement.h"
+#include "../../include/semaphore.h"
+#include <stddef.h>
+
+static int growTable(objectTable_t *table);
+
+void initializeObjectTable(objectTable_t *table, int initialSize, int maxSize) {
+	table->slots = NULL;
+	table->size = 0;
+	table->initialSize = initialSize;
+	table->maxSize = maxSize;
+	table->nextSerial = 0;
+}
+
+void *objectTableGet(objectTable_t *table, int index) {
+	if (index < 0 || index >= table->size) {
+		return NULL;
+	}
+	return table->slots[index].object;
+}
+
+int objectTableAdd(objectTable_t *table, void *object) {
+	int index = 0;
+	while (index < table->size && table->slots[index].object != NULL) {
+		index++;
+	}
+	if (index == table->size && growTable(table) == -1) {
+		return -1;
+	}
+
+	table->slots[index].object = object;
+	table->slots[index].serial = table->nextSerial++;
+	return index;
+}
+
+void objectTableRemove(objectTable_t *table, int index) {
+	if (index >= 0 && index < table->size) {
+		table->slots[index].object = NULL;
+	}
+}
+
+void *objectTableSleep(objectTable_t *table, int index, waitQueueADT queue, uint8_t *lock) {
+	uint32_t serial = table->slots[index].serial;
+	if (waitQueueSleep(queue, lock) == -1) {
+		release(lock);
+		return NULL;
+	}
+
+	// Con el mismo numero de serie es el mismo objeto, asi que 'lock' sigue siendo suyo
+	void *object = objectTableGet(table, index);
+	if (object == NULL || table->slots[index].serial != serial) {
+		return NULL;
+	}
+	acquire(lock);
+	return object;
+}
+
+/**
+ * @brief Duplica la tabla, o la crea con initialSize lugares
+ * @return 0 en caso de exito, -1 si no hay memoria o se llego a maxSize
+ */
+static int growTable(objectTable_t *table) {
+	int size = table->size == 0 ? table->initialSize : table->size * 2;
+	if (size > table->maxSize) {
+		size = table->maxSize;
+	}
+	if (size <= table->size) {
+		return -1;
+	}
+
+	tableSlot_t *slots = mm_alloc(size * sizeof(tableSlot_t));
+	if (slots == NULL) {
+		return -1;
+	}
+	memset(slots, 0, size * sizeof(tableSlot_t));
+	if (table->slots != NULL) {
+		memcpy(slots, table->slots, table->size * sizeof(tableSlot_t));
+		mm_free(table->slots);
+	}
+	table->slots = slots;
+	table->size = size;
+	return 0;
+}
@@ -1,220 +1,567 @@
 #include "../../include/pipes.h"
+#include "../../include/lib.h"
+#include "../../include/memoryManagement.h"
+#include "../../include/objectTable.h"
+#include "../../include/poll.h"
 #include "../../include/semaphore.h"
 #include <stddef.h>
 
-static pipeManager pipes;
-static int next_sem_id = 100;
-
-static int validatePipeId(int *pipeId);
+// Los ids 0 a 2 son de STDIN, STDOUT y STDERR, asi que el pipe con id 'i' esta en el lugar i - 3
+static objectTable_t pipes;
+
+static pipe_t *findPipe(int pipeId);
+static int findNamedPipe(const char *name);
+static int newPipe(int creatorOpen, int16_t creator);
+static int noReaders(pipe_t *pipe);
+static int noWriters(pipe_t *pipe);
+static pipe_t *waitForData(int pipeId, pipe_t *pipe);
+static void ringTake(pipe_t *pipe, char *destination, int size);
+static void ringPut(pipe_t *pipe, const char *source, int size);
+static void dropReference(pipe_t *pipe, int end);
+static void releasePipe(int pipeId, pipe_t *pipe);
+static void destroyPipe(pipe_t *pipe);
 
 void initializePipeManager() {
-	pipes.next_pipe_id = 0;
-	for (int i = 0; i < MAX_PIPES; i++) {
-		pipes.pipes[i].isOpen = 0;
-		pipes.pipes[i].readIdx = 0;
-		pipes.pipes[i].writeIdx = 0;
-		pipes.pipes[i].count = 0;
-		pipes.pipes[i].readers = 0;
-		pipes.pipes[i].writers = 0;
-		pipes.pipes[i].semReaders = -1;
-		pipes.pipes[i].semWriters = -1;
-		pipes.pipes[i].mutex = -1;
-	}
-}
-
-int createPipe() {
-	for (int i = 0; i < MAX_PIPES; i++) {
-		if (!pipes.pipes[i].isOpen) {
-			pipe_t *pipe = &pipes.pipes[i];
-
-			// Limpiar completamente el pipe
-			pipe->readIdx = 0;
-			pipe->writeIdx = 0;
-			pipe->count = 0;
-			pipe->readers = 1; // Inicializar en 1
-			pipe->writers = 1; // Inicializar en 1
-
-			// Limpiar el buffer
-			for (int j = 0; j < PIPE_BUFFER_SIZE; j++) {
-				pipe->buffer[j] = 0;
-			}
+	initializeObjectTable(&pipes, PIPE_TABLE_INITIAL_SIZE, PIPE_MAX_ID - 3);
+}
 
-			pipe->isOpen = 1;
+int createPipe(int16_t creator) {
+	return newPipe(1, creator);
+}
 
-			pipe->semReaders = next_sem_id++;
-			pipe->semWriters = next_sem_id++;
-			pipe->mutex = next_sem_id++;
+int openNamedPipe(const char *name, int end) {
+	if (name == NULL || name[0] == '\0' || (end != PIPE_READ_END && end != PIPE_WRITE_END)) {
+		return -1;
+	}
+	int length = 0;
+	while (name[length] != '\0') {
+		if (++length == PIPE_NAME_LENGTH) {
+			return -1;
+		}
+	}
 
-			if (sem_create(pipe->semReaders, 0) < 0 || sem_create(pipe->semWriters, PIPE_BUFFER_SIZE) < 0 ||
-				sem_create(pipe->mutex, 1) < 0) {
-				return -1;
-			}
+	int pipeId = findNamedPipe(name);
+	if (pipeId == -1) {
+		pipeId = newPipe(0, -1);
+		if (pipeId == -1) {
+			return -1;
+		}
+		memcpy(findPipe(pipeId)->name, name, length + 1);
+	}
+	openPipeEnd(pipeId, end);
+	return pipeId;
+}
 
-			// los primeros 3 son para STDIN, STDOUT y STDERR
-			return i + 3;
+int setPipeCapacity(int pipe_id, int capacity) {
+	pipe_t *pipe = findPipe(pipe_id);
+	if (pipe == NULL || capacity <= 0 || capacity > PIPE_MAX_CAPACITY) {
+		return -1;
+	}
+	if (capacity > PIPE_DEFAULT_CAPACITY) {
+		capacity = (capacity + PIPE_CAPACITY_UNIT - 1) / PIPE_CAPACITY_UNIT * PIPE_CAPACITY_UNIT;
+	}
+
+	acquire(&pipe->lock);
+	if (capacity < pipe->count) {
+		release(&pipe->lock);
+		return -1;
+	}
+	if (capacity != pipe->capacity) {
+		char *buffer = mm_alloc(capacity);
+		if (buffer == NULL) {
+			release(&pipe->lock);
+			return -1;
+		}
+		// Los datos quedan al principio del buffer nuevo
+		int firstSpan = pipe->capacity - pipe->readIdx;
+		if (firstSpan > pipe->count) {
+			firstSpan = pipe->count;
 		}
+		memcpy(buffer, pipe->buffer + pipe->readIdx, firstSpan);
+		memcpy(buffer + firstSpan, pipe->buffer, pipe->count - firstSpan);
+		mm_free(pipe->buffer);
+		pipe->buffer = buffer;
+		pipe->capacity = capacity;
+		pipe->readIdx = 0;
+		pipe->writeIdx = pipe->count % capacity;
+		waitQueueWakeAll(pipe->writersQueue);
 	}
-	return -1;
+	release(&pipe->lock);
+	return capacity;
 }
 
-int readPipe(int pipe_id, char *buffer, int size) {
-	if (validatePipeId(&pipe_id) == -1)
+int readPipe(int pipe_id, char *buffer, int size, int nonBlocking) {
+	pipe_t *pipe = findPipe(pipe_id);
+	if (pipe == NULL || buffer == NULL || size <= 0)
 		return -1;
 
-	if (buffer == NULL || size <= 0)
+	acquire(&pipe->lock);
+	if (nonBlocking && pipe->count == 0 && !noWriters(pipe)) {
+		release(&pipe->lock);
+		return WOULD_BLOCK;
+	}
+
+	// Solo se bloquea con el buffer vacio: si hay datos se devuelve lo que haya, hasta 'size'
+	pipe = waitForData(pipe_id, pipe);
+	if (pipe == NULL) {
 		return -1;
+	}
 
-	pipe_t *pipe = &pipes.pipes[pipe_id];
-	int bytes_read = 0;
+	int bytes_read = size < pipe->count ? size : pipe->count;
+	ringTake(pipe, buffer, bytes_read);
 
-	for (int i = 0; i < size; i++) {
-		sem_wait(pipe->semReaders);
-		sem_wait(pipe->mutex);
+	waitQueueWakeAll(pipe->writersQueue);
+	release(&pipe->lock);
 
-		// Si no hay datos y no hay escritores, retornar EOF
-		if (pipe->count == 0 && pipe->writers == 0) {
-			sem_post(pipe->mutex);
-			return (bytes_read > 0) ? bytes_read : -1;
-		}
-
-		if (pipe->count > 0) {
-			buffer[i] = pipe->buffer[pipe->readIdx];
-			pipe->readIdx = (pipe->readIdx + 1) % PIPE_BUFFER_SIZE;
-			pipe->count--;
-			bytes_read++;
-
-			// Si vaciamos el buffer y no hay writers, retornar lo leído
-			if (pipe->writers == 0 && pipe->count == 0) {
-				sem_post(pipe->mutex);
-				sem_post(pipe->semWriters);
-				return bytes_read;
-			}
+	return bytes_read;
+}
 
-			sem_post(pipe->mutex);
-			sem_post(pipe->semWriters);
+int writePipe(int pipe_id, const char *buffer, int size, int nonBlocking) {
+	pipe_t *pipe = findPipe(pipe_id);
+	if (pipe == NULL || buffer == NULL || size <= 0)
+		return -1;
+
+	int bytes_written = 0;
+
+	acquire(&pipe->lock);
+
+	while (bytes_written < size && !noReaders(pipe)) {
+		// Solo se bloquea con el buffer lleno; lo que entra se copia de una vez
+		if (pipe->count == pipe->capacity) {
+			if (nonBlocking) {
+				release(&pipe->lock);
+				return bytes_written > 0 ? bytes_written : WOULD_BLOCK;
+			}
+			pipe = objectTableSleep(&pipes, pipe_id - 3, pipe->writersQueue, &pipe->lock);
+			if (pipe == NULL) {
+				return bytes_written > 0 ? bytes_written : -1;
+			}
+			continue;
 		}
-		else {
-			// No hay datos, reintentar
-			sem_post(pipe->mutex);
-			i--;
+
+		int span = pipe->capacity - pipe->count;
+		if (span > size - bytes_written) {
+			span = size - bytes_written;
 		}
+		ringPut(pipe, buffer + bytes_written, span);
+		bytes_written += span;
+
+		// Los lectores pueden ir vaciando el buffer mientras el escritor espera lugar para el resto
+		waitQueueWakeAll(pipe->readersQueue);
 	}
 
-	return bytes_read;
-}
+	release(&pipe->lock);
 
-int writePipe(int pipe_id, const char *buffer, int size) {
-	if (validatePipeId(&pipe_id) == -1)
-		return -1;
+	// Sin lectores lo que faltaba no lo va a leer nadie
+	return bytes_written > 0 ? bytes_written : -1;
+}
 
-	if (buffer == NULL || size <= 0)
+int splicePipe(int in_id, int out_id, int size, int nonBlocking) {
+	if (in_id == out_id || size <= 0)
 		return -1;
 
-	pipe_t *pipe = &pipes.pipes[pipe_id];
-	int bytes_written = 0;
+	while (1) {
+		pipe_t *in = findPipe(in_id);
+		pipe_t *out = findPipe(out_id);
+		if (in == NULL || out == NULL)
+			return -1;
 
-	for (int i = 0; i < size; i++) {
-		sem_wait(pipe->semWriters);
+		acquire(&in->lock);
+		if (nonBlocking && in->count == 0 && !noWriters(in)) {
+			release(&in->lock);
+			return WOULD_BLOCK;
+		}
+		in = waitForData(in_id, in);
+		if (in == NULL) {
+			return 0;
+		}
+		// mientras se esperaban datos el destino pudo haberse liberado
+		out = findPipe(out_id);
+		if (out == NULL) {
+			release(&in->lock);
+			return -1;
+		}
 
-		sem_wait(pipe->mutex);
+		acquire(&out->lock);
+		if (noReaders(out)) {
+			release(&out->lock);
+			release(&in->lock);
+			return -1;
+		}
+		if (out->count == out->capacity) {
+			if (nonBlocking) {
+				release(&out->lock);
+				release(&in->lock);
+				return WOULD_BLOCK;
+			}
+			// Se suelta el origen antes de dormir; al volver se empieza de nuevo porque sus datos pudieron cambiar
+			release(&in->lock);
+			out = objectTableSleep(&pipes, out_id - 3, out->writersQueue, &out->lock);
+			if (out != NULL) {
+				release(&out->lock);
+			}
+			continue;
+		}
 
-		if (pipe->count < PIPE_BUFFER_SIZE) {
-			pipe->buffer[pipe->writeIdx] = buffer[i];
-			pipe->writeIdx = (pipe->writeIdx + 1) % PIPE_BUFFER_SIZE;
-			pipe->count++;
-			bytes_written++;
+		int moved = size;
+		if (moved > in->count) {
+			moved = in->count;
 		}
+		if (moved > out->capacity - out->count) {
+			moved = out->capacity - out->count;
+		}
+		// Los bytes van de un buffer circular al otro sin pasar por ningun buffer intermedio
+		int done = 0;
+		while (done < moved) {
+			int span = in->capacity - in->readIdx;
+			if (span > moved - done) {
+				span = moved - done;
+			}
+			ringPut(out, in->buffer + in->readIdx, span);
+			in->readIdx = (in->readIdx + span) % in->capacity;
+			in->count -= span;
+			done += span;
+		}
+
+		waitQueueWakeAll(out->readersQueue);
+		waitQueueWakeAll(in->writersQueue);
+		release(&out->lock);
+		release(&in->lock);
+		return moved;
+	}
+}
 
-		sem_post(pipe->mutex);
+int consumePipe(int pipe_id, int size, pipeConsumer consumer, int nonBlocking) {
+	pipe_t *pipe = findPipe(pipe_id);
+	if (pipe == NULL || consumer == NULL || size <= 0)
+		return -1;
 
-		sem_post(pipe->semReaders);
+	acquire(&pipe->lock);
+	if (nonBlocking && pipe->count == 0 && !noWriters(pipe)) {
+		release(&pipe->lock);
+		return WOULD_BLOCK;
+	}
+	pipe = waitForData(pipe_id, pipe);
+	if (pipe == NULL) {
+		return 0;
 	}
 
-	// debug
-	// printf("writePipe: pipe_id=%d bytes_written=%d\n", pipe_id, bytes_written);
-	return bytes_written;
+	int consumed = size < pipe->count ? size : pipe->count;
+	int firstSpan = pipe->capacity - pipe->readIdx;
+	if (firstSpan > consumed) {
+		firstSpan = consumed;
+	}
+	consumer(pipe->buffer + pipe->readIdx, firstSpan);
+	if (consumed > firstSpan) {
+		consumer(pipe->buffer, consumed - firstSpan);
+	}
+	pipe->readIdx = (pipe->readIdx + consumed) % pipe->capacity;
+	pipe->count -= consumed;
+
+	waitQueueWakeAll(pipe->writersQueue);
+	release(&pipe->lock);
+	return consumed;
 }
 
-int closePipe(int pipe_id) {
-	if (validatePipeId(&pipe_id) == -1)
+int getPipeFlags(int pipe_id) {
+	pipe_t *pipe = findPipe(pipe_id);
+	return pipe == NULL ? -1 : pipe->flags;
+}
+
+int setPipeFlags(int pipe_id, int flags) {
+	pipe_t *pipe = findPipe(pipe_id);
+	if (pipe == NULL || (flags & ~FD_NONBLOCK) != 0)
 		return -1;
 
-	pipe_t *pipe = &pipes.pipes[pipe_id];
+	pipe->flags = flags;
+	return 0;
+}
 
-	sem_wait(pipe->mutex);
+int pipeEvents(int pipe_id) {
+	pipe_t *pipe = findPipe(pipe_id);
+	if (pipe == NULL)
+		return POLLNVAL;
 
-	// Proteger contra underflow
-	if (pipe->writers == 0) {
-		sem_post(pipe->mutex);
-		return 0;
+	acquire(&pipe->lock);
+	int events = 0;
+	if (pipe->count > 0) {
+		events |= POLLIN;
 	}
+	if (noWriters(pipe)) {
+		events |= POLLHUP;
+	}
+	if (noReaders(pipe)) {
+		events |= POLLERR;
+	}
+	else if (pipe->count < pipe->capacity) {
+		events |= POLLOUT;
+	}
+	release(&pipe->lock);
+	return events;
+}
 
-	pipe->writers--;
+int watchPipe(int pipe_id, int events, int16_t pid) {
+	pipe_t *pipe = findPipe(pipe_id);
+	if (pipe == NULL)
+		return -1;
 
-	// Si no hay más writers, señalar EOF a los lectores
-	if (pipe->writers == 0) {
-		// Señalar múltiples veces para despertar lectores bloqueados
-		for (int i = 0; i < PIPE_BUFFER_SIZE; i++) {
-			sem_post(pipe->semReaders);
-		}
+	acquire(&pipe->lock);
+	int result = 0;
+	if ((events & POLLIN) && waitQueueAdd(pipe->readersQueue, pid) == -1) {
+		result = -1;
+	}
+	else if ((events & POLLOUT) && waitQueueAdd(pipe->writersQueue, pid) == -1) {
+		waitQueueRemove(pipe->readersQueue, pid);
+		result = -1;
+	}
+	release(&pipe->lock);
+	return result;
+}
 
-		sem_post(pipe->mutex);
+void unwatchPipe(int pipe_id, int events, int16_t pid) {
+	pipe_t *pipe = findPipe(pipe_id);
+	if (pipe == NULL)
+		return;
 
-		// Destruir y liberar el pipe para reutilizar
-		sem_destroy(pipe->semReaders);
-		sem_destroy(pipe->semWriters);
-		sem_destroy(pipe->mutex);
+	acquire(&pipe->lock);
+	if (events & POLLIN) {
+		waitQueueRemove(pipe->readersQueue, pid);
+	}
+	if (events & POLLOUT) {
+		waitQueueRemove(pipe->writersQueue, pid);
+	}
+	release(&pipe->lock);
+}
 
-		pipe->isOpen = 0;
-		pipe->readIdx = 0;
-		pipe->writeIdx = 0;
-		pipe->count = 0;
-		pipe->readers = 0;
-		pipe->writers = 0;
-		pipe->semReaders = -1;
-		pipe->semWriters = -1;
-		return 0;
+int openPipeEnd(int pipe_id, int end) {
+	pipe_t *pipe = findPipe(pipe_id);
+	if (pipe == NULL)
+		return -1;
+
+	acquire(&pipe->lock);
+	if (end == PIPE_READ_END) {
+		pipe->readers++;
 	}
+	else {
+		pipe->writers++;
+	}
+	pipe->openedEnds |= 1 << end;
+	release(&pipe->lock);
+	return 0;
+}
 
-	sem_post(pipe->mutex);
-	pipe->mutex = -1;
+int closePipeEnd(int pipe_id, int end) {
+	pipe_t *pipe = findPipe(pipe_id);
+	if (pipe == NULL)
+		return -1;
 
+	acquire(&pipe->lock);
+	dropReference(pipe, end);
+	releasePipe(pipe_id, pipe);
 	return 0;
 }
 
-int clearPipe(int pipe_id) {
-	if (validatePipeId(&pipe_id) == -1)
+int closePipe(int pipe_id) {
+	pipe_t *pipe = findPipe(pipe_id);
+	if (pipe == NULL)
 		return -1;
 
-	pipe_t *pipe = &pipes.pipes[pipe_id];
+	acquire(&pipe->lock);
 
-	sem_wait(pipe->mutex);
+	// Proteger contra un segundo close del creador, que soltaria referencias de otros
+	if (!pipe->creatorOpen) {
+		release(&pipe->lock);
+		return -1;
+	}
+	pipe->creatorOpen = 0;
+	dropReference(pipe, PIPE_READ_END);
+	dropReference(pipe, PIPE_WRITE_END);
+	releasePipe(pipe_id, pipe);
+
+	return 0;
+}
+
+int clearPipe(int pipe_id) {
+	pipe_t *pipe = findPipe(pipe_id);
+	if (pipe == NULL)
+		return -1;
+
+	acquire(&pipe->lock);
 
 	pipe->readIdx = 0;
 	pipe->writeIdx = 0;
 	pipe->count = 0;
+	waitQueueWakeAll(pipe->writersQueue);
 
-	sem_post(pipe->mutex);
+	release(&pipe->lock);
 
 	return 0;
 }
 
-static int validatePipeId(int *pipeId) {
-	int id = *pipeId;
+void pipeCancel(int16_t pid) {
+	for (int i = 0; i < pipes.size; i++) {
+		pipe_t *pipe = objectTableGet(&pipes, i);
+		if (pipe == NULL) {
+			continue;
+		}
+		acquire(&pipe->lock);
+		waitQueueRemove(pipe->readersQueue, pid);
+		waitQueueRemove(pipe->writersQueue, pid);
+		release(&pipe->lock);
+	}
+}
 
-	if (id < 3) {
-		return -1;
+void closeCreatedPipes(int16_t pid) {
+	// closePipe puede liberar el pipe y vaciar su lugar, pero la tabla no se achica
+	for (int i = 0; i < pipes.size; i++) {
+		pipe_t *pipe = objectTableGet(&pipes, i);
+		if (pipe != NULL && pipe->creatorOpen && pipe->creator == pid) {
+			closePipe(i + 3);
+		}
 	}
+}
+
+static pipe_t *findPipe(int pipeId) {
+	return objectTableGet(&pipes, pipeId - 3);
+}
 
-	if (id > MAX_PIPES + 2) {
+/**
+ * @brief Busca un pipe con nombre
+ * @return Su ID, o -1 si no hay ninguno con ese nombre
+ */
+static int findNamedPipe(const char *name) {
+	for (int i = 0; i < pipes.size; i++) {
+		pipe_t *pipe = objectTableGet(&pipes, i);
+		if (pipe != NULL && pipe->name[0] != '\0' && strcmp(pipe->name, name) == 0) {
+			return i + 3;
+		}
+	}
+	return -1;
+}
+
+/**
+ * @brief Reserva un pipe vacio en el primer lugar libre de la tabla
+ * @param creatorOpen 1 si quien lo crea se queda con una referencia de cada extremo, 0 si nace sin referencias
+ * @param creator pid de quien lo crea, o -1
+ * @return ID del pipe o -1 si no hay memoria
+ */
+static int newPipe(int creatorOpen, int16_t creator) {
+	pipe_t *pipe = mm_alloc(sizeof(pipe_t));
+	if (pipe == NULL) {
+		return -1;
+	}
+	memset(pipe, 0, sizeof(pipe_t));
+	pipe->buffer = mm_alloc(PIPE_DEFAULT_CAPACITY);
+	pipe->readersQueue = createWaitQueue();
+	pipe->writersQueue = createWaitQueue();
+	if (pipe->buffer == NULL || pipe->readersQueue == NULL || pipe->writersQueue == NULL) {
+		destroyPipe(pipe);
 		return -1;
 	}
 
-	int index = id - 3;
-	if (!pipes.pipes[index].isOpen) {
+	pipe->capacity = PIPE_DEFAULT_CAPACITY;
+	pipe->readers = creatorOpen;
+	pipe->writers = creatorOpen;
+	pipe->creatorOpen = creatorOpen;
+	pipe->creator = creator;
+	pipe->openedEnds = creatorOpen ? (1 << PIPE_READ_END) | (1 << PIPE_WRITE_END) : 0;
+	int index = objectTableAdd(&pipes, pipe);
+	if (index == -1) {
+		destroyPipe(pipe);
 		return -1;
 	}
 
-	*pipeId = index;
-	return 0;
-}
\ No newline at end of file
+	// los primeros 3 son para STDIN, STDOUT y STDERR
+	return index + 3;
+}
+
+/**
+ * @brief Espera con el lock tomado a que el pipe tenga datos
+ * @return El pipe con el lock tomado y datos para leer, o NULL (sin el lock) si llego a EOF o dejo de existir
+ */
+static pipe_t *waitForData(int pipeId, pipe_t *pipe) {
+	while (pipe->count == 0) {
+		// Si no hay datos y no hay escritores, retornar EOF
+		if (noWriters(pipe)) {
+			release(&pipe->lock);
+			return NULL;
+		}
+		pipe = objectTableSleep(&pipes, pipeId - 3, pipe->readersQueue, &pipe->lock);
+		if (pipe == NULL) {
+			return NULL;
+		}
+	}
+	return pipe;
+}
+
+/**
+ * @brief Saca 'size' bytes del buffer circular, que tiene que tenerlos, en a lo sumo dos copias
+ */
+static void ringTake(pipe_t *pipe, char *destination, int size) {
+	int firstSpan = pipe->capacity - pipe->readIdx;
+	if (firstSpan > size) {
+		firstSpan = size;
+	}
+	memcpy(destination, pipe->buffer + pipe->readIdx, firstSpan);
+	memcpy(destination + firstSpan, pipe->buffer, size - firstSpan);
+	pipe->readIdx = (pipe->readIdx + size) % pipe->capacity;
+	pipe->count -= size;
+}
+
+/**
+ * @brief Agrega 'size' bytes al buffer circular, que tiene que tener lugar, en a lo sumo dos copias
+ */
+static void ringPut(pipe_t *pipe, const char *source, int size) {
+	int firstSpan = pipe->capacity - pipe->writeIdx;
+	if (firstSpan > size) {
+		firstSpan = size;
+	}
+	memcpy(pipe->buffer + pipe->writeIdx, source, firstSpan);
+	memcpy(pipe->buffer, source + firstSpan, size - firstSpan);
+	pipe->writeIdx = (pipe->writeIdx + size) % pipe->capacity;
+	pipe->count += size;
+}
+
+/**
+ * @brief Indica si ya no quedan lectores; un FIFO que todavia no tuvo ninguno no cuenta como abandonado
+ */
+static int noReaders(pipe_t *pipe) {
+	return pipe->readers == 0 && (pipe->openedEnds & (1 << PIPE_READ_END));
+}
+
+static int noWriters(pipe_t *pipe) {
+	return pipe->writers == 0 && (pipe->openedEnds & (1 << PIPE_WRITE_END));
+}
+
+/**
+ * @brief Resta una referencia a un extremo y despierta solo a quienes esperaban del otro lado
+ */
+static void dropReference(pipe_t *pipe, int end) {
+	if (end == PIPE_READ_END) {
+		if (pipe->readers > 0 && --pipe->readers == 0) {
+			waitQueueWakeAll(pipe->writersQueue);
+		}
+	}
+	else if (pipe->writers > 0 && --pipe->writers == 0) {
+		waitQueueWakeAll(pipe->readersQueue);
+	}
+}
+
+/**
+ * @brief Suelta el lock del pipe y lo libera si ya no le quedan referencias
+ */
+static void releasePipe(int pipeId, pipe_t *pipe) {
+	release(&pipe->lock);
+	if (pipe->readers == 0 && pipe->writers == 0) {
+		// A esta altura dropReference ya desperto a todos los que esperaban
+		objectTableRemove(&pipes, pipeId - 3);
+		destroyPipe(pipe);
+	}
+}
+
+static void destroyPipe(pipe_t *pipe) {
+	freeWaitQueue(pipe->readersQueue);
+	freeWaitQueue(pipe->writersQueue);
+	mm_free(pipe->buffer);
+	mm_free(pipe);
+}
@@ -0,0 +1,185 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+#include "../../include/poll.h"
+#include "../../include/doubleLinkedList.h"
+#include "../../include/keyboard.h"
+#include "../../include/memoryManagement.h"
+#include "../../include/pipes.h"
+#include "../../include/scheduler.h"
+#include "../../include/time.h"
+#include <stddef.h>
+
+#define NO_DEADLINE UINT64_MAX
+#define KEYBOARD_ID STDIN // id resuelto de un STDIN que no esta redirigido
+
+/*
+ * Proceso bloqueado en poll. Vive en el heap del kernel y no en el stack del proceso para que kill pueda deshacer
+ * lo que anoto aunque corra en el espacio de direcciones de otro proceso.
+ */
+typedef struct {
+	int16_t pid;
+	uint64_t deadline;
+	int count;
+	int16_t ids[POLL_MAX_FDS]; // descriptores ya resueltos: ids de pipes o KEYBOARD_ID
+	int16_t events[POLL_MAX_FDS];
+} poller_t;
+
+static doubleLinkedListADT pollers = NULL;
+
+static int16_t resolveFd(int16_t fd);
+static int16_t readyEvents(int16_t id);
+static int watch(poller_t *poller);
+static void unwatch(poller_t *poller, int count);
+static poller_t *findPoller(int16_t pid);
+
+void initializePoll() {
+	pollers = createDoubleLinkedListADT();
+}
+
+int pollFds(pollfd_t *fds, int nfds, int64_t timeout) {
+	if (fds == NULL || nfds < 0 || nfds > POLL_MAX_FDS || pollers == NULL) {
+		return -1;
+	}
+
+	poller_t *poller = mm_alloc(sizeof(poller_t));
+	if (poller == NULL) {
+		return -1;
+	}
+	poller->pid = getPid();
+	poller->deadline = timeout < 0 ? NO_DEADLINE : ticksElapsed() + timeout;
+	poller->count = 0;
+	for (int i = 0; i < nfds; i++) {
+		if (fds[i].fd >= 0) {
+			poller->ids[poller->count] = resolveFd(fds[i].fd);
+			poller->events[poller->count++] = fds[i].events & (POLLIN | POLLOUT);
+		}
+	}
+
+	while (1) {
+		int ready = 0;
+		for (int i = 0, j = 0; i < nfds; i++) {
+			fds[i].revents = 0;
+			if (fds[i].fd < 0) {
+				continue;
+			}
+			int16_t mask = poller->events[j] | POLLHUP | POLLERR | POLLNVAL;
+			fds[i].revents = readyEvents(poller->ids[j++]) & mask;
+			if (fds[i].revents != 0) {
+				ready++;
+			}
+		}
+		if (ready > 0 || timeout == 0 || ticksElapsed() >= poller->deadline) {
+			mm_free(poller);
+			return ready;
+		}
+
+		// Se anota en todas las colas y se bloquea una sola vez: lo despierta el primero que cambie, o el timer
+		if (watch(poller) == -1) {
+			mm_free(poller);
+			return -1;
+		}
+		if (addNode(pollers, poller) == NULL) {
+			unwatch(poller, poller->count);
+			mm_free(poller);
+			return -1;
+		}
+		blockProcess(poller->pid);
+		removeNode(pollers, poller);
+		unwatch(poller, poller->count);
+	}
+}
+
+void pollTick(uint64_t now) {
+	if (pollers == NULL || isEmpty(pollers)) {
+		return;
+	}
+	toBegin(pollers);
+	while (hasNext(pollers)) {
+		poller_t *poller = nextInList(pollers);
+		if (now >= poller->deadline) {
+			ProcessContext *process = findProcess(poller->pid);
+			if (process != NULL && process->status == BLOCKED) {
+				setReadyProcess(poller->pid);
+			}
+		}
+	}
+}
+
+void pollCancel(int16_t pid) {
+	poller_t *poller = findPoller(pid);
+	if (poller == NULL) {
+		return;
+	}
+	removeNode(pollers, poller);
+	unwatch(poller, poller->count);
+	mm_free(poller);
+}
+
+/**
+ * @brief Traduce un descriptor de poll al id que usa el kernel: 0 a 2 pasan por los del proceso, el resto son pipes
+ */
+static int16_t resolveFd(int16_t fd) {
+	return fd < 3 ? (int16_t) getFd(fd) : fd;
+}
+
+static int16_t readyEvents(int16_t id) {
+	if (id >= 3) {
+		return pipeEvents(id);
+	}
+	switch (id) {
+		case KEYBOARD_ID:
+			return pendingKeys() > 0 ? POLLIN : 0;
+		case STDOUT:
+		case STDERR:
+			// la pantalla nunca bloquea
+			return POLLOUT;
+	}
+	return POLLNVAL;
+}
+
+/**
+ * @brief Anota al proceso en las colas de todos sus descriptores
+ * @return 0 en caso de éxito, o -1 si alguno fallo, despues de deshacer los que ya se habian anotado
+ */
+static int watch(poller_t *poller) {
+	for (int i = 0; i < poller->count; i++) {
+		int result = 0;
+		if (poller->ids[i] >= 3) {
+			result = watchPipe(poller->ids[i], poller->events[i], poller->pid);
+		}
+		else if (poller->ids[i] == KEYBOARD_ID && (poller->events[i] & POLLIN)) {
+			result = waitQueueAdd(keyboardPollers(), poller->pid);
+		}
+		if (result == -1) {
+			unwatch(poller, i);
+			return -1;
+		}
+	}
+	return 0;
+}
+
+static void unwatch(poller_t *poller, int count) {
+	for (int i = 0; i < count; i++) {
+		if (poller->ids[i] >= 3) {
+			unwatchPipe(poller->ids[i], poller->events[i], poller->pid);
+		}
+		else if (poller->ids[i] == KEYBOARD_ID && (poller->events[i] & POLLIN)) {
+			waitQueueRemove(keyboardPollers(), poller->pid);
+		}
+	}
+}
+
+static poller_t *findPoller(int16_t pid) {
+	if (pollers == NULL) {
+		return NULL;
+	}
+	toBegin(pollers);
+	while (hasNext(pollers)) {
+		poller_t *poller = nextInList(pollers);
+		if (poller->pid == pid) {
+			return poller;
+		}
+	}
+	return NULL;
+}
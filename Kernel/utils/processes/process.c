@@ -4,12 +4,23 @@
 #include "../../include/process.h"
 #include "../../include/lib.h"
 #include "../../include/memoryManagement.h"
+#include "../../include/messageQueue.h"
+#include "../../include/paging.h"
+#include "../../include/pipes.h"
 #include "../../include/scheduler.h"
 #include <stdint.h>
 #include <stdio.h>
 
-static void freeArgv(char **argv, int argc);
-static char **allocArgv(char **argv, int argc);
+#define SAVED_RAX_OFFSET (14 * sizeof(uint64_t)) // pushState guarda rax primero, arriba de los otros 14 registros
+#define ARGV_MAX_SIZE (PAGE_SIZE / 2)			   // el resto de la primera pagina queda para el frame inicial
+
+typedef struct allocation_t {
+	void *address;
+	uint64_t size;
+} allocation_t;
+
+static uint64_t pushArgv(uint64_t frameTop, char **args, int argc, char ***argv);
+static allocation_t *findAllocation(ProcessContext *process, void *ptr);
 
 int initializeProcess(ProcessContext *process, int16_t pid, char **args, int argc, uint8_t priority, uint64_t rip,
 					  char ground, int16_t fileDescriptors[]) {
@@ -23,17 +34,33 @@ int initializeProcess(ProcessContext *process, int16_t pid, char **args, int arg
 	process->rip = rip;
 	process->ground = ground;
 	process->waitingList = NULL;
+	process->allocations = NULL;
+	process->memoryUsage = 0;
 	process->status = READY;
+	process->heapBreak = PROCESS_HEAP_BASE;
+	process->residentPages = 0;
 
-	process->stackBase = (uint64_t) mm_alloc(STACK_SIZE);
-	if (process->stackBase == 0) {
+	process->pageTable = createAddressSpace();
+	if (process->pageTable == 0) {
 		return -1;
 	}
-	process->stackBase += STACK_SIZE;
 
-	process->argv = allocArgv(args, argc);
-	if (process->argv == NULL) {
-		mm_free((void *) (process->stackBase - STACK_SIZE));
+	// Solo se mapea la pagina donde va el frame inicial; el resto del stack aparece a medida que se usa
+	uint64_t stackFrame = mapNewPage(process->pageTable, PROCESS_STACK_TOP - PAGE_SIZE);
+	if (stackFrame == 0) {
+		destroyAddressSpace(process->pageTable);
+		process->pageTable = 0;
+		return -1;
+	}
+	process->residentPages = 1;
+	process->stackBase = PROCESS_STACK_TOP;
+
+	// El frame se escribe a traves del mapa por identidad del marco, pero las direcciones son las del proceso
+	uint64_t frameTop = stackFrame + PAGE_SIZE;
+	uint64_t argvPos = pushArgv(frameTop, args, argc, &process->argv);
+	if (argvPos == 0) {
+		destroyAddressSpace(process->pageTable);
+		process->pageTable = 0;
 		process->stackBase = 0;
 		return -1;
 	}
@@ -45,26 +72,49 @@ int initializeProcess(ProcessContext *process, int16_t pid, char **args, int arg
 
 	process->name = mm_alloc(my_strlen(name) + 1);
 	if (process->name == NULL) {
-		freeArgv(process->argv, process->argc);
 		process->argv = NULL;
-		mm_free((void *) (process->stackBase - STACK_SIZE));
+		destroyAddressSpace(process->pageTable);
+		process->pageTable = 0;
 		process->stackBase = 0;
 		return -1;
 	}
 	my_strcpy(process->name, name);
-	process->stackPos = setupStackFrame(process->stackBase, process->rip, argc, process->argv);
+
+	uint64_t framePos =
+		setupStackFrame(argvPos, process->rip, argc, process->argv, process->stackBase - (frameTop - argvPos));
+	process->stackPos = process->stackBase - (frameTop - framePos);
 
 	for (int i = 0; i < CANT_FILE_DESCRIPTORS; i++) {
 		process->fileDescriptors[i] = (fileDescriptors != NULL) ? fileDescriptors[i] : i;
+		process->fdFlags[i] = 0;
+	}
+	for (int i = 0; i < MAX_OPEN_FIFOS; i++) {
+		process->fifos[i].id = -1;
+	}
+	for (int i = 0; i < MAX_OPEN_MQUEUES; i++) {
+		process->mqueues[i] = -1;
 	}
 
 	process->waitingList = createDoubleLinkedListADT();
 	if (process->waitingList == NULL) {
 		mm_free(process->name);
 		process->name = NULL;
-		freeArgv(process->argv, process->argc);
 		process->argv = NULL;
-		mm_free((void *) (process->stackBase - STACK_SIZE));
+		destroyAddressSpace(process->pageTable);
+		process->pageTable = 0;
+		process->stackBase = 0;
+		return -1;
+	}
+
+	process->allocations = createDoubleLinkedListADT();
+	if (process->allocations == NULL) {
+		freeLinkedListADT(process->waitingList);
+		process->waitingList = NULL;
+		mm_free(process->name);
+		process->name = NULL;
+		process->argv = NULL;
+		destroyAddressSpace(process->pageTable);
+		process->pageTable = 0;
 		process->stackBase = 0;
 		return -1;
 	}
@@ -77,19 +127,17 @@ void freeProcess(ProcessContext *pcb) {
 		return;
 	}
 
-	if (pcb->argv != NULL) {
-		freeArgv(pcb->argv, pcb->argc);
-		pcb->argv = NULL;
-	}
-
 	if (pcb->name != NULL) {
 		mm_free(pcb->name);
 		pcb->name = NULL;
 	}
 
-	if (pcb->stackBase >= STACK_SIZE) {
-		mm_free((void *) (pcb->stackBase - STACK_SIZE));
+	// Si es el proceso actual su espacio sigue activo hasta el cambio de contexto, pero nadie reusa los marcos antes
+	if (pcb->pageTable != 0) {
+		destroyAddressSpace(pcb->pageTable);
+		pcb->pageTable = 0;
 		pcb->stackBase = 0;
+		pcb->residentPages = 0;
 	}
 
 	if (pcb->waitingList != NULL) {
@@ -97,9 +145,180 @@ void freeProcess(ProcessContext *pcb) {
 		pcb->waitingList = NULL;
 	}
 
+	if (pcb->allocations != NULL) {
+		freeProcessAllocations(pcb);
+		freeLinkedListADT(pcb->allocations);
+		pcb->allocations = NULL;
+	}
+
 	mm_free(pcb);
 }
 
+void *processAlloc(ProcessContext *process, size_t size) {
+	if (process == NULL || process->allocations == NULL) {
+		return NULL;
+	}
+
+	allocation_t *record = mm_alloc(sizeof(allocation_t));
+	if (record == NULL) {
+		return NULL;
+	}
+
+	record->address = mm_alloc(size);
+	if (record->address == NULL) {
+		mm_free(record);
+		return NULL;
+	}
+	record->size = size;
+
+	if (addNode(process->allocations, record) == NULL) {
+		mm_free(record->address);
+		mm_free(record);
+		return NULL;
+	}
+
+	process->memoryUsage += size;
+	return record->address;
+}
+
+int processFree(ProcessContext *process, void *ptr) {
+	if (process == NULL || ptr == NULL) {
+		return -1;
+	}
+
+	allocation_t *record = findAllocation(process, ptr);
+	if (record == NULL) {
+		return -1;
+	}
+
+	removeNode(process->allocations, record);
+	process->memoryUsage -= record->size;
+	mm_free(record->address);
+	mm_free(record);
+	return 0;
+}
+
+void freeProcessAllocations(ProcessContext *process) {
+	if (process == NULL || process->allocations == NULL) {
+		return;
+	}
+
+	allocation_t *record;
+	while ((record = getFirstData(process->allocations)) != NULL) {
+		mm_free(record->address);
+		mm_free(record);
+	}
+	process->memoryUsage = 0;
+}
+
+void *processSbrk(ProcessContext *process, int64_t increment) {
+	if (process == NULL) {
+		return NULL;
+	}
+
+	uint64_t oldBreak = process->heapBreak;
+	if ((increment > 0 && (uint64_t) increment > PROCESS_HEAP_BASE + PROCESS_HEAP_SIZE - oldBreak) ||
+		(increment < 0 && (uint64_t) -increment > oldBreak - PROCESS_HEAP_BASE)) {
+		return NULL;
+	}
+	uint64_t newBreak = oldBreak + increment;
+
+	// Las paginas que quedan enteras por encima del nuevo fin vuelven al pool
+	for (uint64_t page = (newBreak + PAGE_MASK) & ~(uint64_t) PAGE_MASK; page < oldBreak; page += PAGE_SIZE) {
+		// un hijo no tiene a su cuenta las paginas que todavia comparte con el padre
+		if (unmapPage(process->pageTable, page) == 0 && process->residentPages > 0) {
+			process->residentPages--;
+		}
+	}
+
+	process->heapBreak = newBreak;
+	return (void *) oldBreak;
+}
+
+int64_t handleProcessPageFault(ProcessContext *process, uint64_t address, uint64_t errorCode) {
+	if (process == NULL || process->pageTable == 0) {
+		return -1;
+	}
+
+	if (errorCode & PAGE_FAULT_PRESENT) {
+		if (!(errorCode & PAGE_FAULT_WRITE)) {
+			return -1;
+		}
+		int copied;
+		if (makePageWritable(process->pageTable, address, &copied) == 0) {
+			return -1;
+		}
+		// la copia es un marco nuevo y queda a cuenta de quien la provoco
+		process->residentPages += copied;
+		return 0;
+	}
+
+	int inLocal = address >= PROCESS_LOCAL_BASE && address < PROCESS_LOCAL_BASE + PAGE_SIZE;
+	int inStack = address >= process->stackBase - STACK_SIZE && address < process->stackBase;
+	int inHeap = address >= PROCESS_HEAP_BASE && address < process->heapBreak;
+	if (!inLocal && !inStack && !inHeap) {
+		return -1;
+	}
+
+	if (mapNewPage(process->pageTable, address & ~(uint64_t) PAGE_MASK) == 0) {
+		return -1;
+	}
+	process->residentPages++;
+	return 0;
+}
+
+int initializeForkedProcess(ProcessContext *child, ProcessContext *parent, int16_t pid, uint64_t syscallFrame) {
+	child->pid = pid;
+	child->parentPid = parent->pid;
+	child->priority = parent->priority;
+	child->ground = parent->ground;
+	child->rip = parent->rip;
+	child->argc = parent->argc;
+	child->argv = parent->argv; // vive en el stack, que el hijo recibe copiado en la misma direccion
+	child->status = READY;
+	child->memoryUsage = 0;
+	child->stackBase = parent->stackBase;
+	child->heapBreak = parent->heapBreak;
+	// Los marcos compartidos siguen a cuenta del padre; el hijo suma los que se copian cuando escribe
+	child->residentPages = 0;
+	for (int i = 0; i < CANT_FILE_DESCRIPTORS; i++) {
+		child->fileDescriptors[i] = parent->fileDescriptors[i];
+		child->fdFlags[i] = parent->fdFlags[i];
+	}
+	// openProcessPipes les suma al hijo sus propias referencias
+	for (int i = 0; i < MAX_OPEN_FIFOS; i++) {
+		child->fifos[i] = parent->fifos[i];
+	}
+	for (int i = 0; i < MAX_OPEN_MQUEUES; i++) {
+		child->mqueues[i] = parent->mqueues[i];
+	}
+
+	child->pageTable = cloneAddressSpace(parent->pageTable);
+	if (child->pageTable == 0) {
+		return -1;
+	}
+
+	// Se copia la pagina del hijo donde quedo rax para que en el vea que fork devolvio 0
+	uint64_t raxSlot = syscallFrame + SAVED_RAX_OFFSET;
+	int copied;
+	uint64_t frame = makePageWritable(child->pageTable, raxSlot, &copied);
+	if (frame == 0) {
+		return -1;
+	}
+	child->residentPages += copied;
+	*(uint64_t *) (frame + (raxSlot & PAGE_MASK)) = 0;
+	child->stackPos = syscallFrame;
+
+	child->name = mm_alloc(my_strlen(parent->name) + 1);
+	child->waitingList = createDoubleLinkedListADT();
+	child->allocations = createDoubleLinkedListADT();
+	if (child->name == NULL || child->waitingList == NULL || child->allocations == NULL) {
+		return -1;
+	}
+	my_strcpy(child->name, parent->name);
+	return 0;
+}
+
 int waitProcess(int16_t pid) {
 	ProcessContext *pcb = findProcess(pid);
 	int16_t currentPid = getPid();
@@ -110,7 +329,9 @@ int waitProcess(int16_t pid) {
 	}
 
 	ProcessContext *currentProcess = findProcess(currentPid);
-	addNode(pcb->waitingList, currentProcess);
+	if (addNode(pcb->waitingList, currentProcess) == NULL) {
+		return -1;
+	}
 	blockProcess(currentPid);
 	return 0;
 }
@@ -123,67 +344,189 @@ int changeFileDescriptors(int16_t pid, int16_t fileDescriptors[]) {
 	}
 
 	for (int i = 0; i < CANT_FILE_DESCRIPTORS; i++) {
+		// un descriptor que pasa a apuntar a otra cosa vuelve a ser bloqueante
+		if (process->fileDescriptors[i] != fileDescriptors[i]) {
+			process->fdFlags[i] = 0;
+		}
+		// Se abre el nuevo antes de cerrar el viejo: si son el mismo pipe no llega a quedarse sin referencias
+		int end = i == STDIN ? PIPE_READ_END : PIPE_WRITE_END;
+		if (fileDescriptors[i] >= 3) {
+			openPipeEnd(fileDescriptors[i], end);
+		}
+		if (process->fileDescriptors[i] >= 3) {
+			closePipeEnd(process->fileDescriptors[i], end);
+		}
 		process->fileDescriptors[i] = fileDescriptors[i];
 	}
 
 	return 0;
 }
 
-static void freeArgv(char **argv, int argc) {
-	if (argv == NULL) {
-		return;
+void openProcessPipes(ProcessContext *process) {
+	for (int i = 0; i < CANT_FILE_DESCRIPTORS; i++) {
+		if (process->fileDescriptors[i] >= 3) {
+			openPipeEnd(process->fileDescriptors[i], i == STDIN ? PIPE_READ_END : PIPE_WRITE_END);
+		}
 	}
+	for (int i = 0; i < MAX_OPEN_FIFOS; i++) {
+		if (process->fifos[i].id != -1) {
+			openPipeEnd(process->fifos[i].id, process->fifos[i].end);
+		}
+	}
+}
 
-	for (int i = 0; i < argc; i++) {
-		if (argv[i] != NULL) {
-			mm_free(argv[i]);
+void closeProcessPipes(ProcessContext *process) {
+	closeCreatedPipes(process->pid);
+	for (int i = 0; i < CANT_FILE_DESCRIPTORS; i++) {
+		if (process->fileDescriptors[i] >= 3) {
+			closePipeEnd(process->fileDescriptors[i], i == STDIN ? PIPE_READ_END : PIPE_WRITE_END);
+		}
+	}
+	for (int i = 0; i < MAX_OPEN_FIFOS; i++) {
+		if (process->fifos[i].id != -1) {
+			closePipeEnd(process->fifos[i].id, process->fifos[i].end);
+			process->fifos[i].id = -1;
 		}
 	}
+}
 
-	mm_free(argv);
+int openProcessFifo(ProcessContext *process, const char *name, int end) {
+	int slot = 0;
+	while (slot < MAX_OPEN_FIFOS && process->fifos[slot].id != -1) {
+		slot++;
+	}
+	if (slot == MAX_OPEN_FIFOS) {
+		return -1;
+	}
+
+	int pipeId = openNamedPipe(name, end);
+	if (pipeId == -1) {
+		return -1;
+	}
+	process->fifos[slot].id = pipeId;
+	process->fifos[slot].end = end;
+	return pipeId;
 }
 
-static char **allocArgv(char **argv, int argc) {
-	if (argc <= 0) {
-		char **emptyArgv = mm_alloc(sizeof(char *));
-		if (emptyArgv != NULL) {
-			emptyArgv[0] = NULL;
+int closeProcessFifo(ProcessContext *process, int16_t pipeId, int end) {
+	for (int i = 0; i < MAX_OPEN_FIFOS; i++) {
+		if (process->fifos[i].id == pipeId && process->fifos[i].end == end) {
+			process->fifos[i].id = -1;
+			return closePipeEnd(pipeId, end);
 		}
-		return emptyArgv;
 	}
+	return -1;
+}
 
-	if (argv == NULL) {
-		return NULL;
+int openProcessQueue(ProcessContext *process, const char *name, int depth, int maxSize) {
+	int slot = 0;
+	while (slot < MAX_OPEN_MQUEUES && process->mqueues[slot] != -1) {
+		slot++;
+	}
+	if (slot == MAX_OPEN_MQUEUES) {
+		return -1;
+	}
+
+	int id = mqOpen(name, depth, maxSize);
+	if (id != -1) {
+		process->mqueues[slot] = id;
+	}
+	return id;
+}
+
+int closeProcessQueue(ProcessContext *process, int16_t id) {
+	for (int i = 0; i < MAX_OPEN_MQUEUES; i++) {
+		if (process->mqueues[i] == id) {
+			process->mqueues[i] = -1;
+			return mqClose(id);
+		}
+	}
+	return -1;
+}
+
+int hasProcessQueue(ProcessContext *process, int16_t id) {
+	if (id < 0) {
+		return 0;
+	}
+	for (int i = 0; i < MAX_OPEN_MQUEUES; i++) {
+		if (process->mqueues[i] == id) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+void retainProcessQueues(ProcessContext *process) {
+	for (int i = 0; i < MAX_OPEN_MQUEUES; i++) {
+		if (process->mqueues[i] != -1) {
+			mqRetain(process->mqueues[i]);
+		}
 	}
+}
 
-	char **newArgv = mm_alloc((argc + 1) * sizeof(char *));
-	if (newArgv == NULL) {
+void closeProcessQueues(ProcessContext *process) {
+	for (int i = 0; i < MAX_OPEN_MQUEUES; i++) {
+		if (process->mqueues[i] != -1) {
+			mqCancel(process->mqueues[i], process->pid);
+			mqClose(process->mqueues[i]);
+			process->mqueues[i] = -1;
+		}
+	}
+}
+
+static allocation_t *findAllocation(ProcessContext *process, void *ptr) {
+	if (process->allocations == NULL) {
 		return NULL;
 	}
-	for (int i = 0; i < argc; i++) {
-		if (argv[i] == NULL) {
-			for (int j = 0; j < i; j++) {
-				mm_free(newArgv[j]);
-			}
-			mm_free(newArgv);
-			return NULL;
+
+	toBegin(process->allocations);
+	while (hasNext(process->allocations)) {
+		allocation_t *record = nextInList(process->allocations);
+		if (record->address == ptr) {
+			return record;
 		}
+	}
+	return NULL;
+}
 
-		size_t len = my_strlen(argv[i]);
-		newArgv[i] = mm_alloc(len + 1);
+/**
+ * @brief Copia los argumentos al tope de la primera pagina del stack del proceso
+ * @note  Al quedar en el espacio de direcciones del proceso, un fork se los lleva copiados junto con el stack y
+ *        siguen en la misma direccion, que es la que ya tiene guardada el codigo del hijo
+ * @param frameTop Fin del marco de esa pagina, visto por el mapa por identidad
+ * @param argv Donde se deja la direccion del arreglo, vista desde el proceso
+ * @return Posicion en el marco debajo de los argumentos, alineada a 16, o 0 si son invalidos o no entran
+ */
+static uint64_t pushArgv(uint64_t frameTop, char **args, int argc, char ***argv) {
+	if (argc < 0) {
+		argc = 0;
+	}
+	if (argc > 0 && args == NULL) {
+		return 0;
+	}
 
-		if (newArgv[i] == NULL) {
-			for (int j = 0; j < i; j++) {
-				mm_free(newArgv[j]);
-			}
-			mm_free(newArgv);
-			return NULL;
+	uint64_t size = (argc + 1) * sizeof(char *);
+	for (int i = 0; i < argc; i++) {
+		if (args[i] == NULL) {
+			return 0;
+		}
+		size += my_strlen(args[i]) + 1;
+		if (size > ARGV_MAX_SIZE) {
+			return 0;
 		}
+	}
 
-		my_strcpy(newArgv[i], argv[i]);
+	uint64_t pos = (frameTop - size) & ~(uint64_t) 0xF;
+	char **array = (char **) pos;
+	char *strings = (char *) (array + argc + 1);
+	for (int i = 0; i < argc; i++) {
+		my_strcpy(strings, args[i]);
+		array[i] = (char *) (PROCESS_STACK_TOP - (frameTop - (uint64_t) strings));
+		strings += my_strlen(args[i]) + 1;
 	}
-	newArgv[argc] = NULL;
-	return newArgv;
+	array[argc] = NULL;
+	*argv = (char **) (PROCESS_STACK_TOP - (frameTop - pos));
+	return pos;
 }
 
 int changePriority(int16_t pid, uint8_t priority) {
@@ -3,7 +3,12 @@
 
 #include "../../include/scheduler.h"
 #include "../../include/memoryManagement.h"
+#include "../../include/memoryPressure.h"
+#include "../../include/paging.h"
+#include "../../include/pipes.h"
+#include "../../include/poll.h"
 #include "../../include/process.h"
+#include "../../include/sharedMemory.h"
 #include "../../include/video.h"
 #include "../include/doubleLinkedList.h"
 #include "../include/lib.h"
@@ -14,9 +19,9 @@ static int created = 0;
 
 static schedulerADT getScheduler();
 static void idle();
-static ProcessContext *pipedTo(int16_t fd);
-static int16_t pipedFd(int16_t *fds);
 static int64_t kill(schedulerADT scheduler, ProcessContext *process);
+static int16_t findFreePid();
+static Node *queueProcess(doubleLinkedListADT list, ProcessContext *process);
 
 void createScheduler() {
 	scheduler = (schedulerADT) mm_alloc(sizeof(schedulerCDT));
@@ -50,6 +55,12 @@ uint64_t schedule(uint64_t prevRSP) {
 	if (scheduler == NULL) {
 		return prevRSP;
 	}
+
+	// Si algun pedido se quedo sin memoria se mata a la victima ahora; si era el proceso actual se cambia ya
+	handleMemoryPressure();
+	if (scheduler->currentProcess != NULL && scheduler->currentProcess->status == TERMINATED) {
+		scheduler->quantums = 1;
+	}
 	scheduler->quantums--;
 
 	if (scheduler->processQty == 0 || scheduler->quantums > 0) {
@@ -77,7 +88,7 @@ uint64_t schedule(uint64_t prevRSP) {
 			scheduler->currentProcess->stackPos = prevRSP;
 			if (scheduler->currentProcess->status == RUNNING) {
 				scheduler->currentProcess->status = READY;
-				addNode(scheduler->readyProcess, scheduler->currentProcess);
+				queueProcess(scheduler->readyProcess, scheduler->currentProcess);
 			}
 		}
 	}
@@ -104,6 +115,22 @@ uint64_t schedule(uint64_t prevRSP) {
 	return scheduler->currentProcess->stackPos;
 }
 
+uint64_t getCurrentPageTable() {
+	schedulerADT scheduler = getScheduler();
+	if (scheduler == NULL || scheduler->currentProcess == NULL) {
+		return getKernelPageTable();
+	}
+	return scheduler->currentProcess->pageTable;
+}
+
+ProcessContext *getCurrentProcess() {
+	schedulerADT scheduler = getScheduler();
+	if (scheduler == NULL) {
+		return NULL;
+	}
+	return scheduler->currentProcess;
+}
+
 int16_t createProcess(uint64_t rip, char **args, int argc, uint8_t priority, int16_t fileDescriptors[], char ground) {
 	schedulerADT scheduler = getScheduler();
 	if (scheduler == NULL) {
@@ -121,15 +148,8 @@ int16_t createProcess(uint64_t rip, char **args, int argc, uint8_t priority, int
 
 	memset(newProcess, 0, sizeof(ProcessContext));
 
-	// encontrar minimo pid libre
-	int16_t pid;
-	for (pid = 0; pid < MAX_PROCESS; pid++) {
-		if (findProcess(pid) == NULL) {
-			break;
-		}
-	}
-	if (pid == MAX_PROCESS) {
-		/* no free pid found */
+	int16_t pid = findFreePid();
+	if (pid == -1) {
 		freeProcess(newProcess);
 		return -1;
 	}
@@ -140,20 +160,60 @@ int16_t createProcess(uint64_t rip, char **args, int argc, uint8_t priority, int
 		return -1;
 	}
 
-	addNode(scheduler->processList, newProcess);
-	if (newProcess->status == READY) {
-		addNode(scheduler->readyProcess, newProcess);
+	if (addNode(scheduler->processList, newProcess) == NULL) {
+		freeProcess(newProcess);
+		return -1;
 	}
-	else if (newProcess->status == BLOCKED) {
-		addNode(scheduler->blockedProcess, newProcess);
+	doubleLinkedListADT queue = newProcess->status == BLOCKED ? scheduler->blockedProcess : scheduler->readyProcess;
+	if (addNode(queue, newProcess) == NULL) {
+		removeNode(scheduler->processList, newProcess);
+		freeProcess(newProcess);
+		return -1;
 	}
 
+	openProcessPipes(newProcess);
 	scheduler->processQty++;
 	return newProcess->pid;
 }
 
+int16_t forkProcess(uint64_t syscallFrame) {
+	schedulerADT scheduler = getScheduler();
+	if (scheduler == NULL || scheduler->currentProcess == NULL || scheduler->processQty >= MAX_PROCESS) {
+		return -1;
+	}
+
+	ProcessContext *child = (ProcessContext *) mm_alloc(sizeof(ProcessContext));
+	if (child == NULL) {
+		return -1;
+	}
+	memset(child, 0, sizeof(ProcessContext));
+
+	int16_t pid = findFreePid();
+	if (pid == -1 || initializeForkedProcess(child, scheduler->currentProcess, pid, syscallFrame) == -1) {
+		freeProcess(child);
+		return -1;
+	}
+
+	if (addNode(scheduler->processList, child) == NULL) {
+		freeProcess(child);
+		return -1;
+	}
+	if (addNode(scheduler->readyProcess, child) == NULL) {
+		removeNode(scheduler->processList, child);
+		freeProcess(child);
+		return -1;
+	}
+	openProcessPipes(child);
+	retainProcessQueues(child);
+	scheduler->processQty++;
+	return pid;
+}
+
 int16_t getPid() {
 	schedulerADT scheduler = getScheduler();
+	if (scheduler == NULL) {
+		return -1;
+	}
 	return scheduler->currentPid;
 }
 
@@ -164,7 +224,9 @@ ProcessInfo *ps(uint16_t *processQty) {
 		return NULL;
 	}
 
-	ProcessInfo *array = (ProcessInfo *) mm_alloc(sizeof(ProcessInfo) * scheduler->processQty);
+	// el arreglo y los nombres quedan a cargo de quien pidio la informacion
+	ProcessContext *caller = scheduler->currentProcess;
+	ProcessInfo *array = (ProcessInfo *) processAlloc(caller, sizeof(ProcessInfo) * scheduler->processQty);
 	if (array == NULL) {
 		*processQty = 0;
 		return NULL;
@@ -182,25 +244,30 @@ ProcessInfo *ps(uint16_t *processQty) {
 		array[i].stackPos = aux->stackPos;
 		array[i].stackBase = aux->stackBase;
 		array[i].status = aux->status;
+		array[i].memoryUsage = aux->memoryUsage + aux->residentPages * PAGE_SIZE;
+		array[i].name = aux->name;
+		i++;
+	}
 
-		if (aux->name != NULL) {
-			array[i].name = (char *) mm_alloc(my_strlen(aux->name) + 1);
-			if (array[i].name == NULL) {
-				for (int j = 0; j < i; j++) {
-					if (array[j].name != NULL) {
-						mm_free(array[j].name);
-					}
+	// Los nombres se copian recorriendo el arreglo y no la lista: si falta memoria se buscan procesos en la lista y
+	// eso pisaria el recorrido
+	for (int j = 0; j < i; j++) {
+		if (array[j].name == NULL) {
+			continue;
+		}
+		char *name = (char *) processAlloc(caller, my_strlen(array[j].name) + 1);
+		if (name == NULL) {
+			for (int k = 0; k < j; k++) {
+				if (array[k].name != NULL) {
+					processFree(caller, array[k].name);
 				}
-				mm_free(array);
-				*processQty = 0;
-				return NULL;
 			}
-			my_strcpy(array[i].name, aux->name);
-		}
-		else {
-			array[i].name = NULL;
+			processFree(caller, array);
+			*processQty = 0;
+			return NULL;
 		}
-		i++;
+		my_strcpy(name, array[j].name);
+		array[j].name = name;
 	}
 	*processQty = scheduler->processQty;
 	return array;
@@ -228,7 +295,7 @@ int64_t setReadyProcess(int16_t pid) {
 		if (removeNode(scheduler->blockedProcess, process) == NULL) {
 			return -1;
 		}
-		if (addNode(scheduler->readyProcess, process) == NULL) {
+		if (queueProcess(scheduler->readyProcess, process) == NULL) {
 			return -1;
 		}
 		process->status = READY;
@@ -247,7 +314,7 @@ int64_t blockProcess(int16_t pid) {
 			if (removeNode(scheduler->readyProcess, process) == NULL)
 				return -1;
 		}
-		if (addNode(scheduler->blockedProcess, process) == NULL)
+		if (queueProcess(scheduler->blockedProcess, process) == NULL)
 			return -1;
 
 		process->status = BLOCKED;
@@ -270,6 +337,11 @@ int64_t killCurrentProcess() {
 	return killProcess(scheduler->currentProcess->pid);
 }
 
+int64_t exitCurrentProcess() {
+	schedulerADT scheduler = getScheduler();
+	return kill(scheduler, scheduler->currentProcess);
+}
+
 int64_t killProcess(int16_t pid) {
 	schedulerADT scheduler = getScheduler();
 	ProcessContext *process = findProcess(pid);
@@ -277,17 +349,8 @@ int64_t killProcess(int16_t pid) {
 		return -1;
 	}
 
-	int16_t fd = pipedFd(process->fileDescriptors);
-	if (kill(scheduler, process) == -1) {
-		return -1;
-	}
-	if (fd != -1) {
-		ProcessContext *aux = pipedTo(fd);
-		if (aux != NULL) {
-			return kill(scheduler, aux);
-		}
-	}
-	return 0;
+	// Los que comparten sus pipes no mueren con el: al soltar sus extremos ven EOF o dejan de poder escribir
+	return kill(scheduler, process);
 }
 
 // ground == 0 -->foreground
@@ -296,26 +359,40 @@ int64_t killForegroundProcess() {
 	if (scheduler->currentProcess == NULL) {
 		return -1;
 	}
-	if (scheduler->currentProcess->ground == 0 && scheduler->currentProcess->pid != SHELL_PID) {
-		printf("^C\n");
-		return killCurrentProcess();
-	}
-	else {
-		ProcessContext *aux;
+
+	// Se terminan todas las etapas del pipeline en foreground; kill saca a cada una de la lista, asi que se vuelve a
+	// buscar desde el principio despues de cada una
+	int killed = 0;
+	ProcessContext *victim;
+	do {
+		victim = NULL;
 		toBegin(scheduler->processList);
-		while (hasNext(scheduler->processList)) {
-			aux = nextInList(scheduler->processList);
+		while (victim == NULL && hasNext(scheduler->processList)) {
+			ProcessContext *aux = nextInList(scheduler->processList);
 			if (aux->ground == 0 && aux->pid != SHELL_PID) {
-				printf("^C\n");
-				return kill(scheduler, aux);
+				victim = aux;
 			}
 		}
+		if (victim != NULL) {
+			if (kill(scheduler, victim) == -1) {
+				return -1;
+			}
+			killed++;
+		}
+	} while (victim != NULL);
+
+	// si no habia foreground que no sea la shell no se imprime nada
+	if (killed > 0) {
+		printf("^C\n");
 	}
-	// si no habia foreground que no sea la shell
 	return 0;
 }
 
 int64_t getFd(int64_t fd) {
+	// el descriptor viene de userland: fuera de rango leeria memoria del kernel
+	if (fd < 0 || fd >= CANT_FILE_DESCRIPTORS) {
+		return -1;
+	}
 	schedulerADT scheduler = getScheduler();
 	ProcessContext *process = scheduler->currentProcess;
 	return process->fileDescriptors[fd];
@@ -328,6 +405,7 @@ int16_t copyProcess(ProcessInfo *dest, ProcessContext *src) {
 	dest->priority = src->priority;
 	dest->ground = src->ground;
 	dest->status = src->status;
+	dest->memoryUsage = src->memoryUsage + src->residentPages * PAGE_SIZE;
 
 	if (src->name != NULL) {
 		dest->name = mm_alloc(my_strlen(src->name) + 1);
@@ -343,39 +421,82 @@ int16_t copyProcess(ProcessInfo *dest, ProcessContext *src) {
 	return 0;
 }
 
-static schedulerADT getScheduler() {
-	return scheduler;
-}
+void freeFromOwner(void *ptr) {
+	schedulerADT scheduler = getScheduler();
+	if (ptr == NULL) {
+		return;
+	}
 
-static void idle() {
-	while (1) {
-		_hlt();
+	if (processFree(scheduler->currentProcess, ptr) == 0) {
+		return;
+	}
+
+	toBegin(scheduler->processList);
+	while (hasNext(scheduler->processList)) {
+		ProcessContext *aux = nextInList(scheduler->processList);
+		if (processFree(aux, ptr) == 0) {
+			return;
+		}
 	}
+
+	mm_free(ptr);
 }
 
-static ProcessContext *pipedTo(int16_t fd) {
+int16_t findLargestProcess() {
 	schedulerADT scheduler = getScheduler();
-	ProcessContext *aux;
+	if (scheduler == NULL) {
+		return -1;
+	}
+
+	int16_t victim = -1;
+	uint64_t largest = 0;
 	toBegin(scheduler->processList);
 	while (hasNext(scheduler->processList)) {
-		aux = nextInList(scheduler->processList);
-		if (aux->fileDescriptors[STDIN] == fd || aux->fileDescriptors[STDOUT] == fd) {
-			return aux;
+		ProcessContext *aux = nextInList(scheduler->processList);
+		uint64_t usage = aux->memoryUsage + aux->residentPages * PAGE_SIZE;
+		if (aux->pid == IDLE_PID || aux->pid == SHELL_PID || aux->status == TERMINATED || usage <= largest) {
+			continue;
 		}
+		victim = aux->pid;
+		largest = usage;
 	}
-	return NULL;
+	return victim;
+}
+
+static schedulerADT getScheduler() {
+	return scheduler;
 }
 
-static int16_t pipedFd(int16_t *fds) {
-	if (fds[STDIN] != STDIN) {
-		return fds[STDIN];
+static void idle() {
+	while (1) {
+		_hlt();
 	}
-	else if (fds[STDOUT] != STDOUT) {
-		return fds[STDOUT];
+}
+
+/**
+ * @brief Busca el menor pid que no esta en uso
+ * @return El pid, o -1 si estan todos ocupados
+ */
+static int16_t findFreePid() {
+	for (int16_t pid = 0; pid < MAX_PROCESS; pid++) {
+		if (findProcess(pid) == NULL) {
+			return pid;
+		}
 	}
 	return -1;
 }
 
+/**
+ * @brief Encola un proceso en una de las colas del scheduler usando la reserva si hace falta
+ * @note  Un proceso que no se pudo encolar queda fuera de todas las colas y no vuelve a correr
+ */
+static Node *queueProcess(doubleLinkedListADT list, ProcessContext *process) {
+	beginCriticalAllocation();
+	Node *node = addNode(list, process);
+	endCriticalAllocation();
+	return node;
+}
+
 static int64_t kill(schedulerADT scheduler, ProcessContext *process) {
 	if (process->status == READY) {
 		if (removeNode(scheduler->readyProcess, process) == NULL) {
@@ -400,11 +521,22 @@ static int64_t kill(schedulerADT scheduler, ProcessContext *process) {
 		return -1;
 	}
 	process->status = TERMINATED;
+
+	// todo lo que el proceso pidio con sys_mm_alloc se devuelve al heap ahora, aunque el PCB se libere despues
+	freeProcessAllocations(process);
+	// si estaba en poll o bloqueado en un pipe sale de las colas de espera antes de que su pid se reuse
+	pollCancel(process->pid);
+	pipeCancel(process->pid);
+	// sus extremos de los pipes tambien: el otro lado ve EOF o deja de poder escribir
+	closeProcessPipes(process);
+	closeProcessQueues(process);
+	detachAllSharedMemory(process->pid);
 	scheduler->processQty--;
 
 	if (scheduler->currentProcess != process) {
 		freeProcess(process);
 	}
+	refillMemoryReserve();
 
 	return 0;
 }
\ No newline at end of file
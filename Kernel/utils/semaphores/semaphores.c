@@ -2,6 +2,7 @@
 // PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
 
 #include "../../include/memoryManagement.h"
+#include "../../include/memoryPressure.h"
 #include "../../include/process.h"
 #include "../../include/scheduler.h"
 #include "../../include/semaphore.h"
@@ -90,17 +91,26 @@ int sem_wait(int id) {
 		return 0;
 	}
 
-	// si el contador está en 0 hay que bloquear el proceso
+	// si el contador está en 0 hay que bloquear el proceso. Si no se pudiera encolar nadie lo despertaria, por eso
+	// estas asignaciones pueden usar la reserva
 	int16_t currentPid = getPid();
+	beginCriticalAllocation();
 	int16_t *pid = (int16_t *) mm_alloc(sizeof(int16_t));
 	if (pid == NULL) {
+		endCriticalAllocation();
 		release(&sem->spinlock);
 		return -1;
 	}
 
 	*pid = currentPid;
 
-	addNode(sem->waitQueue, (void *) pid);
+	if (addNode(sem->waitQueue, (void *) pid) == NULL) {
+		endCriticalAllocation();
+		mm_free(pid);
+		release(&sem->spinlock);
+		return -1;
+	}
+	endCriticalAllocation();
 
 	release(&sem->spinlock);
 
@@ -156,6 +166,34 @@ int sem_post(int id) {
 	return 0;
 }
 
+int sem_purgeWaiters() {
+	if (semManager == NULL) {
+		return 0;
+	}
+
+	int purged = 0;
+	for (int i = 0; i < NUM_SEMS; i++) {
+		semaphore_t *sem = &semManager->semaphores[i];
+		// un semaforo tomado es el que esta usando quien pidio memoria: no se puede tocar su cola
+		if (!sem->active || sem->spinlock != 0) {
+			continue;
+		}
+
+		toBegin(sem->waitQueue);
+		while (hasNext(sem->waitQueue)) {
+			int16_t *pid = (int16_t *) nextInList(sem->waitQueue);
+			ProcessContext *proc = findProcess(*pid);
+
+			if (proc == NULL || proc->status == TERMINATED) {
+				removeNode(sem->waitQueue, (void *) pid);
+				mm_free(pid);
+				purged++;
+			}
+		}
+	}
+	return purged;
+}
+
 static int isValidSemId(int id) {
 	if (id < 0 || id >= NUM_SEMS) {
 		return -1;
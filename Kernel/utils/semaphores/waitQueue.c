@@ -0,0 +1,98 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+#include "../../include/waitQueue.h"
+#include "../../include/doubleLinkedList.h"
+#include "../../include/memoryManagement.h"
+#include "../../include/memoryPressure.h"
+#include "../../include/scheduler.h"
+#include "../../include/semaphore.h"
+#include <stddef.h>
+
+typedef struct waitQueueCDT {
+	doubleLinkedListADT waiting; // PIDs de los procesos bloqueados, en orden de llegada
+} waitQueueCDT;
+
+waitQueueADT createWaitQueue() {
+	waitQueueADT queue = mm_alloc(sizeof(waitQueueCDT));
+	if (queue == NULL) {
+		return NULL;
+	}
+	queue->waiting = createDoubleLinkedListADT();
+	if (queue->waiting == NULL) {
+		mm_free(queue);
+		return NULL;
+	}
+	return queue;
+}
+
+void freeWaitQueue(waitQueueADT queue) {
+	if (queue == NULL) {
+		return;
+	}
+	while (!isEmpty(queue->waiting)) {
+		int16_t *pid = (int16_t *) getFirstData(queue->waiting);
+		removeNode(queue->waiting, pid);
+		mm_free(pid);
+	}
+	freeLinkedListADT(queue->waiting);
+	mm_free(queue);
+}
+
+int waitQueueSleep(waitQueueADT queue, uint8_t *lock) {
+	int16_t currentPid = getPid();
+	if (waitQueueAdd(queue, currentPid) == -1) {
+		return -1;
+	}
+
+	release(lock);
+	blockProcess(currentPid);
+	return 0;
+}
+
+int waitQueueAdd(waitQueueADT queue, int16_t pid) {
+	// Igual que en sem_wait: si no se pudiera encolar nadie lo despertaria, asi que puede usar la reserva
+	beginCriticalAllocation();
+	int16_t *entry = (int16_t *) mm_alloc(sizeof(int16_t));
+	if (entry == NULL) {
+		endCriticalAllocation();
+		return -1;
+	}
+	*entry = pid;
+	if (addNode(queue->waiting, entry) == NULL) {
+		endCriticalAllocation();
+		mm_free(entry);
+		return -1;
+	}
+	endCriticalAllocation();
+	return 0;
+}
+
+void waitQueueRemove(waitQueueADT queue, int16_t pid) {
+	toBegin(queue->waiting);
+	while (hasNext(queue->waiting)) {
+		int16_t *entry = (int16_t *) nextInList(queue->waiting);
+		if (*entry == pid) {
+			removeNode(queue->waiting, entry);
+			mm_free(entry);
+			return;
+		}
+	}
+}
+
+int waitQueueWakeAll(waitQueueADT queue) {
+	int woken = 0;
+	while (!isEmpty(queue->waiting)) {
+		int16_t *pid = (int16_t *) getFirstData(queue->waiting);
+		removeNode(queue->waiting, pid);
+
+		// los que murieron mientras esperaban solo dejan su entrada
+		ProcessContext *process = findProcess(*pid);
+		if (process != NULL && process->status == BLOCKED) {
+			setReadyProcess(*pid);
+			woken++;
+		}
+		mm_free(pid);
+	}
+	return woken;
+}
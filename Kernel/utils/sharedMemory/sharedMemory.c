@@ -0,0 +1,116 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+#include "../../include/sharedMemory.h"
+#include "../../include/memoryManagement.h"
+#include "../../include/scheduler.h"
+#include <stddef.h>
+
+static shmManager shm;
+
+static shmSegment_t *findSegment(int key);
+static int validatePid(int16_t pid);
+static void releaseReference(shmSegment_t *segment, int16_t pid);
+
+void initializeSharedMemoryManager() {
+	for (int i = 0; i < MAX_SHM_SEGMENTS; i++) {
+		shm.segments[i].isOpen = 0;
+		shm.segments[i].address = NULL;
+		shm.segments[i].references = 0;
+	}
+}
+
+void *createSharedMemory(int key, uint64_t size) {
+	int16_t pid = getPid();
+	if (size == 0 || size > MM_MAX_ALLOC || validatePid(pid) == -1 || findSegment(key) != NULL) {
+		return NULL;
+	}
+
+	for (int i = 0; i < MAX_SHM_SEGMENTS; i++) {
+		shmSegment_t *segment = &shm.segments[i];
+		if (segment->isOpen) {
+			continue;
+		}
+
+		segment->address = mm_alloc(size);
+		if (segment->address == NULL) {
+			return NULL;
+		}
+		segment->key = key;
+		segment->size = size;
+		segment->references = 1;
+		for (int j = 0; j < MAX_PROCESS; j++) {
+			segment->attachments[j] = 0;
+		}
+		segment->attachments[pid] = 1;
+		segment->isOpen = 1;
+		return segment->address;
+	}
+	return NULL;
+}
+
+void *attachSharedMemory(int key) {
+	int16_t pid = getPid();
+	shmSegment_t *segment = findSegment(key);
+	// El contador por proceso es de 8 bits: si diera la vuelta, al morir el proceso no se soltarian sus adjuntos
+	if (segment == NULL || validatePid(pid) == -1 || segment->attachments[pid] == UINT8_MAX) {
+		return NULL;
+	}
+
+	segment->attachments[pid]++;
+	segment->references++;
+	return segment->address;
+}
+
+int detachSharedMemory(int key) {
+	int16_t pid = getPid();
+	shmSegment_t *segment = findSegment(key);
+	if (segment == NULL || validatePid(pid) == -1 || segment->attachments[pid] == 0) {
+		return -1;
+	}
+
+	releaseReference(segment, pid);
+	return 0;
+}
+
+void detachAllSharedMemory(int16_t pid) {
+	if (validatePid(pid) == -1) {
+		return;
+	}
+
+	for (int i = 0; i < MAX_SHM_SEGMENTS; i++) {
+		shmSegment_t *segment = &shm.segments[i];
+		while (segment->isOpen && segment->attachments[pid] > 0) {
+			releaseReference(segment, pid);
+		}
+	}
+}
+
+static shmSegment_t *findSegment(int key) {
+	for (int i = 0; i < MAX_SHM_SEGMENTS; i++) {
+		if (shm.segments[i].isOpen && shm.segments[i].key == key) {
+			return &shm.segments[i];
+		}
+	}
+	return NULL;
+}
+
+static int validatePid(int16_t pid) {
+	if (pid < 0 || pid >= MAX_PROCESS) {
+		return -1;
+	}
+	return 0;
+}
+
+/**
+ * @brief Quita un adjunto del proceso y libera el bloque si era el ultimo
+ */
+static void releaseReference(shmSegment_t *segment, int16_t pid) {
+	segment->attachments[pid]--;
+	segment->references--;
+	if (segment->references == 0) {
+		mm_free(segment->address);
+		segment->address = NULL;
+		segment->isOpen = 0;
+	}
+}
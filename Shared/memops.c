@@ -0,0 +1,119 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+#include "memops.h"
+#include <stdint.h>
+
+#define WORD_SIZE sizeof(uint64_t)
+#define ERMSB_BIT (1 << 9)		   // CPUID.(EAX=7, ECX=0):EBX, rep movsb/stosb rapidos
+#define REP_BYTES_THRESHOLD 2048 // Por debajo el arranque de rep movsb/stosb cuesta mas que copiar por palabras
+
+/* Palabra de 64 bits que puede estar en cualquier direccion */
+typedef uint64_t __attribute__((aligned(1), may_alias)) unalignedWord;
+
+/*
+ * -1 mientras no se consulto CPUID. Tiene valor inicial para quedar en .data: userland limpia el .bss con memset
+ * y borraria el resultado en medio de la llamada.
+ */
+static int8_t ermsb = -1;
+
+static int hasErmsb(void);
+static void repStosb(void *destination, uint8_t value, uint64_t count);
+static void repStosq(void *destination, uint64_t value, uint64_t count);
+static void repMovsb(void *destination, const void *source, uint64_t count);
+static void repMovsq(void *destination, const void *source, uint64_t count);
+
+void *memset(void *destination, int32_t c, uint64_t length) {
+	uint8_t *dst = (uint8_t *) destination;
+	uint8_t chr = (uint8_t) c;
+
+	if (length < WORD_SIZE) {
+		for (uint64_t i = 0; i < length; i++) {
+			dst[i] = chr;
+		}
+		return destination;
+	}
+
+	uint64_t pattern = chr * 0x0101010101010101ULL;
+	// La primera y la ultima palabra se escriben desalineadas y cubren lo que las palabras alineadas no alcanzan
+	*(unalignedWord *) dst = pattern;
+	*(unalignedWord *) (dst + length - WORD_SIZE) = pattern;
+	if (length <= 2 * WORD_SIZE) {
+		return destination;
+	}
+
+	if (length >= REP_BYTES_THRESHOLD && hasErmsb()) {
+		repStosb(dst, chr, length);
+		return destination;
+	}
+
+	uint64_t head = WORD_SIZE - ((uint64_t) dst & (WORD_SIZE - 1));
+	repStosq(dst + head, pattern, (length - head) / WORD_SIZE);
+	return destination;
+}
+
+void *memcpy(void *destination, const void *source, uint64_t length) {
+	uint8_t *dst = (uint8_t *) destination;
+	const uint8_t *src = (const uint8_t *) source;
+
+	if (length < WORD_SIZE) {
+		for (uint64_t i = 0; i < length; i++) {
+			dst[i] = src[i];
+		}
+		return destination;
+	}
+
+	// Las dos palabras de los extremos se leen antes de escribir nada, asi un destino solapado no las pisa
+	uint64_t first = *(const unalignedWord *) src;
+	uint64_t last = *(const unalignedWord *) (src + length - WORD_SIZE);
+	if (length <= 2 * WORD_SIZE) {
+		*(unalignedWord *) dst = first;
+		*(unalignedWord *) (dst + length - WORD_SIZE) = last;
+		return destination;
+	}
+
+	if (length >= REP_BYTES_THRESHOLD && hasErmsb()) {
+		repMovsb(dst, src, length);
+		return destination;
+	}
+
+	// Se alinea el destino: las escrituras desalineadas son las que mas cuestan
+	uint64_t head = WORD_SIZE - ((uint64_t) dst & (WORD_SIZE - 1));
+	*(unalignedWord *) dst = first;
+	repMovsq(dst + head, src + head, (length - head) / WORD_SIZE);
+	*(unalignedWord *) (dst + length - WORD_SIZE) = last;
+	return destination;
+}
+
+/**
+ * @brief Consulta una sola vez si el procesador tiene ERMSB (Enhanced REP MOVSB/STOSB)
+ */
+static int hasErmsb(void) {
+	if (ermsb == -1) {
+		uint32_t maxLeaf, ebx, ecx, edx;
+		__asm__ volatile("cpuid" : "=a"(maxLeaf), "=b"(ebx), "=c"(ecx), "=d"(edx) : "a"(0), "c"(0));
+		uint32_t features = 0;
+		if (maxLeaf >= 7) {
+			uint32_t eax;
+			__asm__ volatile("cpuid" : "=a"(eax), "=b"(features), "=c"(ecx), "=d"(edx) : "a"(7), "c"(0));
+		}
+		ermsb = (features & ERMSB_BIT) != 0;
+	}
+	return ermsb;
+}
+
+static void repStosb(void *destination, uint8_t value, uint64_t count) {
+	__asm__ volatile("rep stosb" : "+D"(destination), "+c"(count) : "a"(value) : "memory");
+}
+
+static void repStosq(void *destination, uint64_t value, uint64_t count) {
+	__asm__ volatile("rep stosq" : "+D"(destination), "+c"(count) : "a"(value) : "memory");
+}
+
+static void repMovsb(void *destination, const void *source, uint64_t count) {
+	__asm__ volatile("rep movsb" : "+D"(destination), "+S"(source), "+c"(count) : : "memory");
+}
+
+static void repMovsq(void *destination, const void *source, uint64_t count) {
+	__asm__ volatile("rep movsq" : "+D"(destination), "+S"(source), "+c"(count) : : "memory");
+}
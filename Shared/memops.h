@@ -0,0 +1,31 @@
+#ifndef _MEMOPS_H
+#define _MEMOPS_H
+
+#include <stdint.h>
+
+/*
+ * memset y memcpy compartidos por el kernel y userland: los dos modulos compilan Shared/memops.c.
+ */
+
+/**
+ * @brief  Escribe 'character' en una direccion de memoria 'length' veces
+ * @note   Los tramos largos se escriben con rep stosq, o con rep stosb si el procesador tiene ERMSB
+ * @param  destination: Lugar a escribir
+ * @param  character: Elemento a copiar
+ * @param  length: Cantidad de veces que se desea escrbir el valor
+ * @return destination
+ */
+void *memset(void *destination, int32_t character, uint64_t length);
+
+/**
+ * @brief  Copia a 'destination' 'length' bytes de 'source'
+ * @note   Copia hacia adelante, asi que el destino puede solaparse con la fuente si esta al menos 8 bytes antes
+ *         (el scroll de la pantalla depende de esto). Cualquier otro solapamiento no esta soportado
+ * @param  destination: Direccion de destino
+ * @param  source: Fuente
+ * @param  length: Cantidad de bytes a copiar
+ * @return destination
+ */
+void *memcpy(void *destination, const void *source, uint64_t length);
+
+#endif
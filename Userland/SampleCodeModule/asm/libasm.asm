@@ -1,6 +1,8 @@
 EXTERN printRegisters
 GLOBAL usrGetInfoReg
 GLOBAL kaboom
+GLOBAL tryAcquire
+GLOBAL release
 
 ; Para obtener los valores de los registros en tiempo real, usar esta funcion
 usrGetInfoReg:
@@ -45,4 +47,16 @@ usrGetInfoReg:
 
 kaboom:
     UD2
-    ret
\ No newline at end of file
+    ret
+
+; Intenta tomar un spinlock sin bloquear. Devuelve 1 si se obtuvo, 0 si estaba ocupado
+tryAcquire:
+    mov al, 1
+    xchg [rdi], al
+    xor al, 1
+    movzx rax, al
+    ret
+
+release:
+    mov byte [rdi], 0
+    ret
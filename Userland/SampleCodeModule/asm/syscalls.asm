@@ -35,6 +35,28 @@ GLOBAL sys_pipe_create
 GLOBAL sys_pipe_read
 GLOBAL sys_pipe_write
 GLOBAL sys_pipe_close
+GLOBAL sys_mm_stats
+GLOBAL sys_mm_profile
+GLOBAL sys_sbrk
+GLOBAL sys_shm_create
+GLOBAL sys_shm_attach
+GLOBAL sys_shm_detach
+GLOBAL sys_fork
+GLOBAL sys_read_buffer
+GLOBAL sys_write_buffer
+GLOBAL sys_readv
+GLOBAL sys_writev
+GLOBAL sys_pipe_setCapacity
+GLOBAL sys_splice
+GLOBAL sys_poll
+GLOBAL sys_get_fd_flags
+GLOBAL sys_set_fd_flags
+GLOBAL sys_pipe_open
+GLOBAL sys_pipe_close_end
+GLOBAL sys_mq_open
+GLOBAL sys_mq_close
+GLOBAL sys_mq_send
+GLOBAL sys_mq_receive
 
 sys_read:
     mov rax, 0
@@ -215,3 +237,113 @@ sys_pipe_close:
     mov rax, 35
     int 80h
     ret
+
+sys_mm_stats:
+    mov rax, 37
+    int 80h
+    ret
+
+sys_mm_profile:
+    mov rax, 38
+    int 80h
+    ret
+
+sys_sbrk:
+    mov rax, 39
+    int 80h
+    ret
+
+sys_shm_create:
+    mov rax, 40
+    int 80h
+    ret
+
+sys_shm_attach:
+    mov rax, 41
+    int 80h
+    ret
+
+sys_shm_detach:
+    mov rax, 42
+    int 80h
+    ret
+
+sys_fork:
+    mov rax, 43
+    int 80h
+    ret
+
+sys_read_buffer:
+    mov rax, 44
+    int 80h
+    ret
+
+sys_write_buffer:
+    mov rax, 45
+    int 80h
+    ret
+
+sys_readv:
+    mov rax, 46
+    int 80h
+    ret
+
+sys_writev:
+    mov rax, 47
+    int 80h
+    ret
+
+sys_pipe_setCapacity:
+    mov rax, 48
+    int 80h
+    ret
+
+sys_splice:
+    mov rax, 49
+    int 80h
+    ret
+
+sys_poll:
+    mov rax, 50
+    int 80h
+    ret
+
+sys_get_fd_flags:
+    mov rax, 51
+    int 80h
+    ret
+
+sys_set_fd_flags:
+    mov rax, 52
+    int 80h
+    ret
+
+sys_pipe_open:
+    mov rax, 53
+    int 80h
+    ret
+
+sys_pipe_close_end:
+    mov rax, 54
+    int 80h
+    ret
+
+sys_mq_open:
+    mov rax, 55
+    int 80h
+    ret
+
+sys_mq_close:
+    mov rax, 56
+    int 80h
+    ret
+
+sys_mq_send:
+    mov rax, 57
+    int 80h
+    ret
+
+sys_mq_receive:
+    mov rax, 58
+    int 80h
+    ret
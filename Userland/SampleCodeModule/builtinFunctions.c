@@ -11,6 +11,8 @@
 #include "include/tests.h"
 #include <stdint.h>
 
+#define MEMPROF_SITES 10
+
 /* ------------------------ Funciones built-in de la shell ------------------------ */
 
 void bi_help(int argc, char **argv) {
@@ -32,7 +34,11 @@ void bi_help(int argc, char **argv) {
 		"kill               Mata un proceso dado su ID. Uso: kill <pid>\n"
 		"nice               Cambia la prioridad de un proceso dado su ID y la nueva prioridad.\n"
 		"                   Uso: nice <pid> <priority>\n"
-		"mem                Muestra el estado de la memoria: total, ocupada y libre. Uso: mem\n\n"
+		"mem                Muestra el estado de la memoria: total, ocupada y libre. Uso: mem\n"
+		"memstats           Muestra estadisticas del heap: pico de uso, desperdicio por redondeo y\n"
+		"                   fragmentacion de los bloques libres. Uso: memstats\n"
+		"memprof            Lista los sitios del kernel que mas memoria retienen (requiere compilar con\n"
+		"                   --profile). Uso: memprof\n\n"
 
 		"-------------APLICACIONES DE USUARIO-------------\n"
 		"clear              Limpia completamente la pantalla. Uso: clear\n"
@@ -155,3 +161,62 @@ void bi_mem(int argc) {
 	printf("Usada: %u bytes\n", info.used);
 	printf("Libre: %u bytes\n", info.free);
 }
+
+void bi_memstats(int argc) {
+	if (argc != 0) {
+		printf("Uso: memstats\n");
+		return;
+	}
+	mm_stats_t stats;
+	sys_mm_stats(&stats);
+
+	printf("Memoria total: %u bytes\n", stats.size);
+	printf("Usada: %u bytes (pico: %u bytes)\n", stats.used, stats.peakUsed);
+	printf("Libre: %u bytes (bloque mas grande: %u bytes)\n", stats.free, stats.largestFreeBlock);
+	printf("Pedidos: %u bytes, otorgados: %u bytes\n", stats.requestedBytes, stats.grantedBytes);
+	printf("Allocs: %u, frees: %u, fallidos: %u\n", stats.allocCount, stats.freeCount, stats.failedCount);
+	printf("Inicializacion del heap: %u ciclos\n", stats.initCycles);
+
+	// Fragmentacion externa: que parte de la memoria libre no esta en el bloque mas grande
+	uint64_t fragmentation = 0;
+	if (stats.free > 0) {
+		fragmentation = 100 - (stats.largestFreeBlock * 100) / stats.free;
+	}
+	printf("Fragmentacion externa: %u%%\n", fragmentation);
+
+	printf("Bloques libres por tamaño:\n");
+	for (int i = 0; i < MM_STATS_BUCKETS; i++) {
+		if (stats.freeBlocks[i] != 0) {
+			printf("  >= %u bytes: %u\n", (uint64_t) 1 << i, stats.freeBlocks[i]);
+		}
+	}
+}
+
+void bi_memprof(int argc) {
+	if (argc != 0) {
+		printf("Uso: memprof\n");
+		return;
+	}
+	memProfileSite_t sites[MEMPROF_SITES];
+	int64_t count = sys_mm_profile(sites, MEMPROF_SITES);
+	if (count < 0) {
+		printf("El kernel se compilo sin el profiler de memoria (./compile.sh --profile).\n");
+		return;
+	}
+	if (count == 0) {
+		printf("No hay asignaciones muestreadas vivas.\n");
+		return;
+	}
+
+	// Las direcciones se traducen a funciones con: addr2line -f -e Kernel/kernel.elf <caller>
+	for (int64_t i = 0; i < count; i++) {
+		printf("0x%16x  ", sites[i].caller);
+		if (sites[i].pid < 0) {
+			printf("kernel");
+		}
+		else {
+			printf("pid %d", sites[i].pid);
+		}
+		printf("  %u bytes vivos (%u muestras)\n", sites[i].liveBytes, sites[i].samples);
+	}
+}
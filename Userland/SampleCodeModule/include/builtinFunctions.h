@@ -16,6 +16,8 @@
 
 void bi_help(int argc, char **argv);
 void bi_mem(int argc);
+void bi_memstats(int argc);
+void bi_memprof(int argc);
 void bi_kill(int argc, char **argv);
 void bi_block(int argc, char **argv);
 void bi_unblock(int argc, char **argv);
@@ -1,5 +1,8 @@
 #ifndef _LIBASM_H
 #define _LIBASM_H
+
+#include <stdint.h>
+
 /**
  * @brief Permite obtener el valor de los registros en tiempo real
  *
@@ -10,4 +13,17 @@ void usrGetInfoReg();
  *
  */
 void kaboom();
+
+/**
+ * @brief Intenta adquirir un spinlock sin bloquear
+ * @param lock: Puntero al lock
+ * @return 1 si se adquirio el lock, 0 si estaba ocupado
+ */
+int tryAcquire(uint8_t *lock);
+
+/**
+ * @brief Libera un spinlock
+ * @param lock: Puntero al lock
+ */
+void release(uint8_t *lock);
 #endif
\ No newline at end of file
@@ -1,8 +1,6 @@
 #ifndef LOADER_H
 #define LOADER_H
 
-#include <stdint.h>
+#include "../../../Shared/memops.h"
 
-void *memset(void *destination, int32_t c, uint64_t length);
-
-#endif
\ No newline at end of file
+#endif
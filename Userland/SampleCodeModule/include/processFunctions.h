@@ -14,9 +14,11 @@ typedef struct command {
 	char ground; // 1 si es foreground, 0 si es background
 } command;
 
+#define MAX_PIPELINE_STAGES 8 /* Con MAX_ARGS palabras por linea no entran mas comandos separados por '|' */
+
 typedef struct pipecmd {
-	command cmd1;
-	command cmd2;
+	command cmds[MAX_PIPELINE_STAGES]; // en orden: cada uno lee lo que escribe el anterior
+	int count;
 } pipeCmd;
 
 /* -------------------------------------------------------------------
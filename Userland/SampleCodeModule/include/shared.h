@@ -6,6 +6,12 @@
 #define MIN_PRIORITY 1
 #define MAX_PRIORITY 10
 
+/*
+ * Pagina propia de cada proceso que el kernel entrega en cero la primera vez que se toca.
+ * Debe coincidir con PROCESS_LOCAL_BASE del kernel.
+ */
+#define PROCESS_LOCAL_BASE 0x8000000000ULL
+
 /* Tipo para identificador de procesos en userland */
 typedef int16_t pid_t;
 
@@ -18,6 +24,74 @@ typedef struct mem {
 	uint64_t free;
 } mem_t;
 
+#define MM_STATS_BUCKETS 32
+
+/*
+ * Estadisticas del memory manager. Debe coincidir con mm_stats_t del kernel.
+ */
+typedef struct mm_stats {
+	uint64_t size;
+	uint64_t used;
+	uint64_t free;
+	uint64_t peakUsed;
+	uint64_t requestedBytes;
+	uint64_t grantedBytes;
+	uint64_t largestFreeBlock;
+	uint64_t allocCount;
+	uint64_t freeCount;
+	uint64_t failedCount;
+	uint64_t initCycles;
+	uint64_t freeBlocks[MM_STATS_BUCKETS]; // bloques libres con tamaño en [2^i, 2^(i+1)) bytes
+} mm_stats_t;
+
+/*
+ * Sitio de asignacion informado por el profiler del heap. Debe coincidir con memProfileSite_t del kernel.
+ */
+typedef struct memProfileSite {
+	uint64_t caller;
+	int64_t pid;
+	uint64_t liveBytes;
+	uint64_t samples;
+} memProfileSite_t;
+
+/*
+ * Tramo de memoria para sys_readv y sys_writev. Debe coincidir con iovec_t de Kernel/syscalls.c.
+ */
+typedef struct iovec {
+	void *base;
+	uint64_t length;
+} iovec_t;
+
+#define PIPE_READ_END 0
+#define PIPE_WRITE_END 1
+#define PIPE_NAME_LENGTH 32 /* incluye el '\0' */
+
+#define MQ_NAME_LENGTH 32 /* incluye el '\0' */
+#define MQ_MAX_DEPTH 64
+#define MQ_MAX_MESSAGE 1024
+#define MQ_PRIORITIES 8
+
+#define FD_NONBLOCK 0x1 /* ver sys_set_fd_flags */
+#define WOULD_BLOCK (-2) /* lo que devuelve una lectura o escritura no bloqueante que tendria que esperar */
+
+#define POLLIN 0x1	 /* hay datos para leer, o el pipe llego a EOF */
+#define POLLOUT 0x2	 /* se puede escribir sin bloquear */
+#define POLLHUP 0x4	 /* el pipe ya no tiene escritores */
+#define POLLERR 0x8	 /* el pipe ya no tiene lectores */
+#define POLLNVAL 0x10 /* el descriptor no es un pipe ni una terminal */
+
+#define POLL_MAX_FDS 16
+#define POLL_FOREVER (-1)
+
+/*
+ * Descriptor para sys_poll. Debe coincidir con pollfd_t de Kernel/include/poll.h.
+ */
+typedef struct pollfd {
+	int16_t fd;
+	int16_t events;
+	int16_t revents;
+} pollfd_t;
+
 /*
  * Información de un proceso dado.
  */
@@ -30,6 +104,7 @@ typedef struct ProcessInfo {
 
 	uint64_t stackBase;
 	uint64_t stackPos;
+	uint64_t memoryUsage; /* Bytes pedidos con sys_mm_alloc mas las paginas propias que el proceso toco */
 } ProcessInfo;
 
 #endif
\ No newline at end of file
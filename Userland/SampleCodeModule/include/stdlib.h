@@ -34,5 +34,17 @@ int strtoh(char *s, char **end);
  */
 int itoa(uint64_t n, char *buffer, int base);
 
+/**
+ * @brief Reserva memoria dinamica en userland
+ * @note  Los pedidos chicos se sirven desde arenas locales sin entrar al kernel; los grandes van a sys_mm_alloc
+ * @param size: Cantidad de bytes a reservar
+ * @return Puntero al bloque o NULL si no hay memoria
+ */
+void *malloc(uint64_t size);
+
+/**
+ * @brief Libera un bloque obtenido con malloc, ignora NULL
+ * @param ptr: Puntero devuelto por malloc
+ */
 void free(void *ptr);
 #endif
\ No newline at end of file
@@ -20,7 +20,7 @@ void sys_write(int fd, char c);
 /**
  * @brief Lee un byte a partir del descriptor recibido
  * @param fd: FileDescriptor (STDIN | KBDIN)
- * @return Byte leido
+ * @return Byte leido, o 0 si el descriptor es no bloqueante y no habia nada
  */
 uint8_t sys_read(int fd);
 
@@ -90,8 +90,11 @@ Color sys_getFontColor();
 
 /**
  * @brief Reserva memoria dinámica dentro del heap administrado
+ * @note  El bloque queda a nombre del proceso y el kernel lo libera cuando este termina. Sale del heap del kernel,
+ *        que todos los procesos ven en la misma direccion: un hijo creado con fork no recibe una copia sino el mismo
+ *        bloque. malloc no lo usa; para memoria propia del proceso conviene malloc
  *
- * @param size Cantidad de bytes a reservar
+ * @param size Cantidad de bytes a reservar, hasta 128 KiB
  * @return void* Puntero al bloque asignado, o NULL si no hay espacio
  */
 void *sys_mm_alloc(size_t size);
@@ -110,6 +113,106 @@ void sys_mm_free(void *const restrict ptr);
  */
 void sys_mm_info(mem_t *info);
 
+/**
+ * @brief Obtiene estadisticas detalladas del heap: pico de uso, bytes pedidos contra otorgados y un
+ *        histograma de los bloques libres para medir la fragmentacion
+ *
+ * @param stats Puntero donde se escribirán las estadisticas
+ */
+void sys_mm_stats(mm_stats_t *stats);
+
+/**
+ * @brief Obtiene los sitios de asignacion que mas memoria retienen segun el profiler del heap
+ *
+ * @param sites Arreglo donde se escriben los sitios, de mayor a menor por bytes vivos
+ * @param max Capacidad del arreglo
+ * @return int64_t Cantidad de sitios escritos, o -1 si el kernel se compilo sin MM_PROFILE
+ */
+int64_t sys_mm_profile(memProfileSite_t *sites, uint32_t max);
+
+/**
+ * @brief Mueve el fin del heap propio del proceso
+ * @note  Las paginas nuevas se mapean en cero la primera vez que se tocan y son invisibles para los demas procesos
+ *
+ * @param increment Bytes a agregar (o quitar si es negativo)
+ * @return void* Fin anterior del heap, o NULL si se excede el tamaño del heap
+ */
+void *sys_sbrk(int64_t increment);
+
+/**
+ * @brief Crea un segmento de memoria compartida y lo adjunta al proceso
+ * @note  Todos los procesos que se adjuntan ven el mismo bloque en la misma direccion, sin copias
+ *
+ * @param key Clave con la que otros procesos se adjuntan
+ * @param size Tamaño del segmento en bytes, hasta 128 KiB (lo mas grande que reserva el heap del kernel)
+ * @return void* Direccion del segmento, o NULL si la clave ya existe, el tamaño pasa de 128 KiB o no hay memoria
+ */
+void *sys_shm_create(int key, uint64_t size);
+
+/**
+ * @brief Adjunta un segmento de memoria compartida existente
+ *
+ * @param key Clave del segmento
+ * @return void* Direccion del segmento, o NULL si no existe o el proceso ya lo adjunto 255 veces sin soltarlo
+ */
+void *sys_shm_attach(int key);
+
+/**
+ * @brief Suelta un segmento; se libera cuando el ultimo proceso lo suelta o termina
+ *
+ * @param key Clave del segmento
+ * @return int64_t 0 si éxito, -1 si el proceso no lo tenia adjunto
+ */
+int64_t sys_shm_detach(int key);
+
+/**
+ * @brief Duplica el proceso actual; los dos siguen desde el retorno de esta llamada
+ * @note  La memoria propia no se copia al crear el hijo: las paginas se comparten y cada una se copia recien cuando
+ *        alguno de los dos la escribe
+ *
+ * @return int16_t PID del hijo en el padre, 0 en el hijo, o -1 si no se pudo crear
+ */
+int16_t sys_fork();
+
+/**
+ * @brief Lee hasta 'count' bytes de un descriptor con una sola llamada al kernel
+ * @note  Del teclado espera una tecla y devuelve las que ya se hayan escrito; de un pipe, lo que tenga disponible
+ * @param fd: FileDescriptor (STDIN | KBDIN | pipe redirigido)
+ * @param buffer: Donde se dejan los bytes
+ * @param count: Capacidad del buffer
+ * @return int64_t Bytes leidos, WOULD_BLOCK si es no bloqueante y no habia nada, o -1 si el pipe llego a EOF o el
+ *         descriptor no se puede leer
+ */
+int64_t sys_read_buffer(int fd, char *buffer, uint64_t count);
+
+/**
+ * @brief Escribe 'count' bytes en un descriptor con una sola llamada al kernel
+ * @param fd: FileDescriptor (STDOUT | STDERR | pipe redirigido)
+ * @param buffer: Bytes a escribir
+ * @param count: Cantidad de bytes
+ * @return int64_t Bytes escritos, WOULD_BLOCK si es no bloqueante y el pipe esta lleno, o -1 si el descriptor no se
+ *         puede escribir
+ */
+int64_t sys_write_buffer(int fd, const char *buffer, uint64_t count);
+
+/**
+ * @brief Lee en varios tramos con una sola llamada al kernel; se detiene en el primero que no se llena
+ * @param fd: FileDescriptor
+ * @param iov: Tramos a llenar, en orden
+ * @param iovcnt: Cantidad de tramos
+ * @return int64_t Bytes leidos en total, o -1 si no se pudo leer nada
+ */
+int64_t sys_readv(int fd, const iovec_t *iov, uint32_t iovcnt);
+
+/**
+ * @brief Escribe varios tramos, en orden, con una sola llamada al kernel
+ * @param fd: FileDescriptor
+ * @param iov: Tramos a escribir
+ * @param iovcnt: Cantidad de tramos
+ * @return int64_t Bytes escritos en total, o -1 si no se pudo escribir nada
+ */
+int64_t sys_writev(int fd, const iovec_t *iov, uint32_t iovcnt);
+
 /**
  * @brief Crea un nuevo proceso
  * @param rip Dirección de instrucción de entrada (función a ejecutar)
@@ -223,24 +326,25 @@ int sys_sem_destroy(int id);
 /**
  * @brief Crea un nuevo pipe para comunicación entre procesos
  * @return File descriptor del pipe creado, o -1 si error
+ * @note Si el proceso termina sin llamar a sys_pipe_close, el kernel suelta sus referencias de creador
  */
 int sys_pipe_create();
 
 /**
- * @brief Lee datos de un pipe (bloqueante hasta que haya datos)
+ * @brief Lee datos de un pipe (bloqueante hasta que haya datos, salvo con FD_NONBLOCK)
  * @param pipeId Identificador del pipe
  * @param buffer Buffer donde escribir los datos leídos
  * @param count Cantidad de bytes a leer
- * @return Cantidad de bytes leídos, o -1 si error
+ * @return Cantidad de bytes leídos, WOULD_BLOCK, o -1 si error
  */
 int sys_pipe_read(int pipeId, char *buffer, int count);
 
 /**
- * @brief Escribe datos en un pipe (bloqueante si no hay espacio)
+ * @brief Escribe datos en un pipe (bloqueante si no hay espacio, salvo con FD_NONBLOCK)
  * @param pipeId Identificador del pipe
  * @param buffer Buffer con los datos a escribir
  * @param count Cantidad de bytes a escribir
- * @return Cantidad de bytes escritos, o -1 si error
+ * @return Cantidad de bytes escritos, WOULD_BLOCK, o -1 si error
  */
 int sys_pipe_write(int pipeId, const char *buffer, int count);
 
@@ -251,4 +355,108 @@ int sys_pipe_write(int pipeId, const char *buffer, int count);
  */
 int sys_pipe_close(int pipeId);
 
+/**
+ * @brief Abre un extremo de un pipe con nombre (FIFO), creandolo si todavia no existe
+ * @note  Procesos independientes que usan el mismo nombre comparten el pipe. Hasta que el otro extremo se abre por
+ *        primera vez, leer o escribir espera en vez de dar EOF o -1. La referencia se suelta con sys_pipe_close_end o
+ *        al terminar el proceso, y los hijos creados con sys_fork la heredan
+ * @param name Nombre del pipe, hasta PIPE_NAME_LENGTH - 1 caracteres
+ * @param end PIPE_READ_END o PIPE_WRITE_END
+ * @return Identificador del pipe, para sys_pipe_read/sys_pipe_write, o -1 si error
+ */
+int sys_pipe_open(const char *name, int end);
+
+/**
+ * @brief Cierra un extremo abierto con sys_pipe_open
+ * @param pipeId Identificador devuelto por sys_pipe_open
+ * @param end El mismo extremo que se abrio
+ * @return 0 si éxito, -1 si el proceso no tenia abierto ese extremo
+ */
+int sys_pipe_close_end(int pipeId, int end);
+
+/**
+ * @brief Abre una cola de mensajes por nombre, creandola si todavia no existe
+ * @note  A diferencia de un pipe cada envio llega entero en una sola recepcion. La cola se cierra con sys_mq_close o
+ *        al terminar el proceso, la heredan los hijos creados con sys_fork y se libera con el ultimo cierre
+ * @param name Nombre de la cola, hasta MQ_NAME_LENGTH - 1 caracteres
+ * @param depth Mensajes que entran antes de que sys_mq_send bloquee, hasta MQ_MAX_DEPTH (solo al crearla)
+ * @param maxSize Tamaño maximo de cada mensaje, hasta MQ_MAX_MESSAGE (solo al crearla)
+ * @return Identificador de la cola, o -1 si error
+ */
+int sys_mq_open(const char *name, int depth, int maxSize);
+
+/**
+ * @brief Cierra una cola abierta con sys_mq_open
+ * @param id Identificador de la cola
+ * @return 0 si éxito, -1 si el proceso no la tenia abierta
+ */
+int sys_mq_close(int id);
+
+/**
+ * @brief Envia un mensaje entero; bloquea mientras la cola este llena
+ * @param id Identificador de la cola, abierta por este proceso (o heredada con fork)
+ * @param message Contenido del mensaje
+ * @param length Tamaño del mensaje, hasta el maximo de la cola
+ * @param priority De 0 a MQ_PRIORITIES - 1; los de mayor prioridad se reciben primero
+ * @return 0 si éxito, -1 si error o si el proceso no tiene abierta la cola
+ */
+int sys_mq_send(int id, const char *message, int length, int priority);
+
+/**
+ * @brief Recibe el mensaje de mayor prioridad (entre iguales, el mas viejo); bloquea mientras la cola este vacia
+ * @param id Identificador de la cola, abierta por este proceso (o heredada con fork)
+ * @param buffer Donde se copia el mensaje
+ * @param size Capacidad del buffer; si el mensaje no entra queda en la cola
+ * @param priority Donde se deja la prioridad del mensaje, o NULL
+ * @return Tamaño del mensaje, o -1 si error, si el buffer es chico o si el proceso no tiene abierta la cola
+ */
+int sys_mq_receive(int id, char *buffer, int size, int *priority);
+
+/**
+ * @brief Cambia la capacidad del buffer de un pipe (por defecto 512 bytes)
+ * @note  Los valores mayores a 512 se redondean a un multiplo de 4 KiB; el maximo es 64 KiB
+ * @param pipeId Identificador del pipe
+ * @param capacity Capacidad pedida en bytes
+ * @return Capacidad resultante, o -1 si error
+ */
+int sys_pipe_setCapacity(int pipeId, int capacity);
+
+/**
+ * @brief Mueve datos de un pipe a otro pipe o a la pantalla dentro del kernel, sin copiarlos a userland
+ * @note  Bloquea hasta que haya datos y lugar, y devuelve lo que se pudo mover de una vez
+ * @param fdIn FileDescriptor de origen, que tiene que ser un pipe
+ * @param fdOut FileDescriptor de destino (STDOUT | STDERR | pipe redirigido)
+ * @param count Maximo de bytes a mover
+ * @return Bytes movidos, 0 si el origen llego a EOF, o -1 si el origen no es un pipe o el destino no se puede escribir
+ */
+int64_t sys_splice(int fdIn, int fdOut, uint64_t count);
+
+/**
+ * @brief Espera a que alguno de varios descriptores se pueda leer o escribir sin bloquear
+ * @note  STDIN, STDOUT y STDERR se resuelven con los del proceso; desde 3 son ids de pipes, como en sys_pipe_read
+ * @param fds Descriptores a vigilar, hasta POLL_MAX_FDS; los de fd negativo se ignoran
+ * @param nfds Cantidad de descriptores
+ * @param timeout Ticks del timer a esperar: 0 solo consulta, POLL_FOREVER espera sin limite
+ * @return Cantidad de descriptores listos (con revents cargado), 0 si vencio el timeout, o -1 en caso de error
+ */
+int64_t sys_poll(pollfd_t *fds, uint32_t nfds, int64_t timeout);
+
+/**
+ * @brief Devuelve los flags de un descriptor
+ * @param fd: FileDescriptor (STDIN | STDOUT | STDERR), o id de un pipe
+ * @return Los flags (0 o FD_NONBLOCK), o -1 si el pipe no existe
+ */
+int sys_get_fd_flags(int fd);
+
+/**
+ * @brief Cambia los flags de un descriptor
+ * @note  Con FD_NONBLOCK las lecturas y escrituras que tendrian que esperar devuelven WOULD_BLOCK (sys_read devuelve
+ *        0). Los de STDIN, STDOUT y STDERR son de cada proceso y se heredan con fork; los de un id de pipe los comparten
+ *        todos los que lo usan con sys_pipe_read y sys_pipe_write
+ * @param fd: FileDescriptor (STDIN | STDOUT | STDERR), o id de un pipe
+ * @param flags: 0 o FD_NONBLOCK
+ * @return 0 en caso de éxito, -1 si los flags son invalidos o el pipe no existe
+ */
+int sys_set_fd_flags(int fd, int flags);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,242 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+#include "include/shared.h"
+#include "include/stdlib.h"
+#include "include/syscalls.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#define CHUNK_SIZE (64 * 1024)	/* Cuanto se agranda el heap del proceso cada vez */
+#define MIN_CLASS_EXP 5			/* Clase mas chica: 32 bytes (16 de header + 16 utiles) */
+#define MAX_CLASS_EXP 12		/* Clase mas grande: 4096 bytes */
+#define CLASS_COUNT (MAX_CLASS_EXP - MIN_CLASS_EXP + 1)
+#define LARGE_CLASS 0xFF		/* Marca de bloque grande, de paginas enteras del heap */
+#define LARGE_ALIGN 4096		/* Los bloques grandes ocupan paginas enteras */
+#define HEADER_MAGIC 0xA110C8ED /* Permite descartar punteros que no salieron de malloc */
+
+/*
+ * Header de cada bloque. Ocupa 16 bytes para que el puntero devuelto quede alineado a 16.
+ */
+typedef struct BlockHeader {
+	uint32_t magic;
+	uint8_t sizeClass;
+	uint8_t reserved[3];
+	uint64_t size; // solo se usa en los bloques grandes: bytes que ocupa, header incluido
+} BlockHeader;
+
+typedef struct FreeBlock {
+	struct FreeBlock *next;
+} FreeBlock;
+
+/*
+ * Bloque grande libre. Ocupa el lugar del header mientras nadie lo usa.
+ */
+typedef struct LargeBlock {
+	struct LargeBlock *next;
+	uint64_t size;
+} LargeBlock;
+
+/*
+ * Cada proceso tiene su propio espacio de direcciones, asi que el estado de malloc no puede vivir en una variable
+ * global (el modulo es el mismo para todos). La arena esta en la pagina local del proceso, que arranca en cero, y
+ * todos los bloques, tambien los grandes, salen de su heap privado: ningun otro proceso los ve, por eso no hacen
+ * falta locks, y un fork le deja al hijo su propia copia de cada uno en la misma direccion.
+ */
+typedef struct Arena {
+	uint8_t *chunkPos;
+	uint8_t *chunkEnd;
+	FreeBlock *freeLists[CLASS_COUNT];
+	LargeBlock *largeFree; // ordenada por direccion para poder juntar vecinos
+} Arena;
+
+#define ARENA ((Arena *) PROCESS_LOCAL_BASE)
+
+static int getSizeClass(uint64_t size);
+static void *allocFromArena(Arena *arena, int sizeClass);
+static void *allocLarge(uint64_t size);
+static void freeLarge(BlockHeader *header);
+
+void *malloc(uint64_t size) {
+	if (size == 0) {
+		return NULL;
+	}
+
+	int sizeClass = getSizeClass(size);
+	if (sizeClass < 0) {
+		return allocLarge(size);
+	}
+
+	BlockHeader *header = allocFromArena(ARENA, sizeClass);
+	if (header == NULL) {
+		return NULL;
+	}
+	header->magic = HEADER_MAGIC;
+	header->sizeClass = (uint8_t) sizeClass;
+	return (void *) (header + 1);
+}
+
+void free(void *ptr) {
+	if (ptr == NULL) {
+		return;
+	}
+
+	BlockHeader *header = (BlockHeader *) ptr - 1;
+	if (header->magic != HEADER_MAGIC) {
+		return;
+	}
+	header->magic = 0;
+
+	if (header->sizeClass == LARGE_CLASS) {
+		freeLarge(header);
+		return;
+	}
+
+	if (header->sizeClass >= CLASS_COUNT) {
+		return;
+	}
+
+	int sizeClass = header->sizeClass;
+	FreeBlock *block = (FreeBlock *) header;
+	block->next = ARENA->freeLists[sizeClass];
+	ARENA->freeLists[sizeClass] = block;
+}
+
+/**
+ * @brief Calcula la clase de tamaño para un pedido (incluyendo el header)
+ * @return Indice de la clase, o -1 si el pedido debe ir directo al kernel
+ */
+static int getSizeClass(uint64_t size) {
+	uint64_t total = size + sizeof(BlockHeader);
+	if (total > ((uint64_t) 1 << MAX_CLASS_EXP)) {
+		return -1;
+	}
+
+	int exp = MIN_CLASS_EXP;
+	while (((uint64_t) 1 << exp) < total) {
+		exp++;
+	}
+	return exp - MIN_CLASS_EXP;
+}
+
+/**
+ * @brief Obtiene un bloque de la clase pedida: primero de la free list, si no del chunk actual
+ * @note  Agrandar el heap no cuesta memoria hasta que se toca. Si desde el chunk anterior no se pidio ningun bloque
+ *        grande, el chunk nuevo es contiguo y lo extiende
+ */
+static void *allocFromArena(Arena *arena, int sizeClass) {
+	FreeBlock *block = arena->freeLists[sizeClass];
+	if (block != NULL) {
+		arena->freeLists[sizeClass] = block->next;
+		return block;
+	}
+
+	uint64_t blockSize = (uint64_t) 1 << (sizeClass + MIN_CLASS_EXP);
+	if (arena->chunkPos == NULL || (uint64_t) (arena->chunkEnd - arena->chunkPos) < blockSize) {
+		uint8_t *chunk = sys_sbrk(CHUNK_SIZE);
+		if (chunk == NULL) {
+			return NULL;
+		}
+		if (chunk != arena->chunkEnd) {
+			// El resto del chunk anterior se reparte en las clases menores para no perderlo
+			while (arena->chunkPos != NULL && arena->chunkEnd - arena->chunkPos >= ((int64_t) 1 << MIN_CLASS_EXP)) {
+				int rest = CLASS_COUNT - 1;
+				while (((int64_t) 1 << (rest + MIN_CLASS_EXP)) > arena->chunkEnd - arena->chunkPos) {
+					rest--;
+				}
+				FreeBlock *leftover = (FreeBlock *) arena->chunkPos;
+				leftover->next = arena->freeLists[rest];
+				arena->freeLists[rest] = leftover;
+				arena->chunkPos += (uint64_t) 1 << (rest + MIN_CLASS_EXP);
+			}
+			arena->chunkPos = chunk;
+		}
+		arena->chunkEnd = chunk + CHUNK_SIZE;
+	}
+
+	void *result = arena->chunkPos;
+	arena->chunkPos += blockSize;
+	return result;
+}
+
+/**
+ * @brief Obtiene un bloque grande: el primero de la lista de libres donde entre, o paginas nuevas al final del heap
+ */
+static void *allocLarge(uint64_t size) {
+	uint64_t total = (size + sizeof(BlockHeader) + LARGE_ALIGN - 1) & ~(uint64_t) (LARGE_ALIGN - 1);
+	if (total < size || total > INT64_MAX) {
+		return NULL;
+	}
+
+	LargeBlock **link = &ARENA->largeFree;
+	while (*link != NULL && (*link)->size < total) {
+		link = &(*link)->next;
+	}
+
+	LargeBlock *block = *link;
+	if (block == NULL) {
+		block = sys_sbrk((int64_t) total);
+		if (block == NULL) {
+			return NULL;
+		}
+	}
+	else if (block->size > total) {
+		// Lo que sobra queda libre en el mismo lugar de la lista
+		LargeBlock *rest = (LargeBlock *) ((uint8_t *) block + total);
+		rest->next = block->next;
+		rest->size = block->size - total;
+		*link = rest;
+	}
+	else {
+		*link = block->next;
+	}
+
+	BlockHeader *header = (BlockHeader *) block;
+	header->magic = HEADER_MAGIC;
+	header->sizeClass = LARGE_CLASS;
+	header->size = total;
+	return (void *) (header + 1);
+}
+
+/**
+ * @brief Devuelve un bloque grande a la lista, juntandolo con sus vecinos libres
+ * @note  Si termina justo en el fin del heap, esas paginas vuelven al kernel
+ */
+static void freeLarge(BlockHeader *header) {
+	LargeBlock *block = (LargeBlock *) header;
+	block->size = header->size;
+
+	LargeBlock *prev = NULL;
+	LargeBlock *next = ARENA->largeFree;
+	while (next != NULL && next < block) {
+		prev = next;
+		next = next->next;
+	}
+
+	if (next != NULL && (uint8_t *) block + block->size == (uint8_t *) next) {
+		block->size += next->size;
+		next = next->next;
+	}
+	block->next = next;
+	if (prev != NULL && (uint8_t *) prev + prev->size == (uint8_t *) block) {
+		prev->size += block->size;
+		prev->next = next;
+		block = prev;
+	}
+	else if (prev != NULL) {
+		prev->next = block;
+	}
+	else {
+		ARENA->largeFree = block;
+	}
+
+	if (block->next != NULL || (uint8_t *) block + block->size != sys_sbrk(0)) {
+		return;
+	}
+	LargeBlock **link = &ARENA->largeFree;
+	while (*link != block) {
+		link = &(*link)->next;
+	}
+	*link = NULL;
+	sys_sbrk(-(int64_t) block->size);
+}
@@ -18,6 +18,8 @@
 #define PAUSE_SPREAD_STEPS 4
 #define MVAR_VALUE_BYTES 1
 #define READER_PALETTE_SIZE 6
+#define MVAR_QUEUE_NAME "mvar" // escritores y lectores abren la misma cola, como el semaforo de impresion es uno solo
+#define MVAR_DEPTH 1			// un solo lugar: poner bloquea mientras la variable esta llena y sacar mientras esta vacia
 
 static const struct {
 	Color color;
@@ -34,16 +36,14 @@ static uint64_t mvar_reader(int argc, char **argv);
 static void random_pause(void);
 static char writer_value(int writer_id);
 static Color reader_color(int reader_id);
-static bool pipe_write_all(int pipe_id, const char *buffer, int byte_count);
-static bool pipe_read_all(int pipe_id, char *buffer, int byte_count);
+static bool mvar_put(int queue_id, char value);
+static bool mvar_take(int queue_id, char *value);
 static int ensure_print_semaphore(void);
 static void log_spawn_error(const char *role, int id);
-static void spawn_writer(int id, int value_pipe_id, int16_t descriptors[], uint8_t priority, char background);
-static void spawn_reader(int id, int value_pipe_id, int16_t descriptors[], uint8_t priority, char background);
-static void compose_writer_args(int id, int value_pipe_id, char *name_buf, char *writer_id_buf, char *value_pipe_buf,
-								char *argv_out[]);
-static void compose_reader_args(int id, int value_pipe_id, char *name_buf, char *reader_id_buf, char *value_pipe_buf,
-								char *argv_out[]);
+static void spawn_writer(int id, int16_t descriptors[], uint8_t priority, char background);
+static void spawn_reader(int id, int16_t descriptors[], uint8_t priority, char background);
+static void compose_writer_args(int id, char *name_buf, char *writer_id_buf, char *argv_out[]);
+static void compose_reader_args(int id, char *name_buf, char *reader_id_buf, char *argv_out[]);
 
 static void random_pause(void) {
 	int spins = MIN_PAUSE_STEPS + (int) getUniform(PAUSE_SPREAD_STEPS);
@@ -63,18 +63,18 @@ static Color reader_color(int reader_id) {
 	return reader_palette[reader_id % READER_PALETTE_SIZE].color;
 }
 
-static bool pipe_write_all(int pipe_id, const char *buffer, int byte_count) {
-	if (pipe_id < 0 || buffer == NULL || byte_count <= 0) {
+static bool mvar_put(int queue_id, char value) {
+	if (queue_id < 0) {
 		return false;
 	}
-	return sys_pipe_write(pipe_id, buffer, byte_count) == byte_count;
+	return sys_mq_send(queue_id, &value, MVAR_VALUE_BYTES, 0) == 0;
 }
 
-static bool pipe_read_all(int pipe_id, char *buffer, int byte_count) {
-	if (pipe_id < 0 || buffer == NULL || byte_count <= 0) {
+static bool mvar_take(int queue_id, char *value) {
+	if (queue_id < 0 || value == NULL) {
 		return false;
 	}
-	return sys_pipe_read(pipe_id, buffer, byte_count) == byte_count;
+	return sys_mq_receive(queue_id, value, MVAR_VALUE_BYTES, NULL) == MVAR_VALUE_BYTES;
 }
 
 static int ensure_print_semaphore(void) {
@@ -92,59 +92,51 @@ static void log_spawn_error(const char *role, int id) {
 	}
 }
 
-static void spawn_writer(int id, int value_pipe_id, int16_t descriptors[], uint8_t priority, char background) {
+static void spawn_writer(int id, int16_t descriptors[], uint8_t priority, char background) {
 	char writer_id_buf[12];
-	char value_pipe_buf[12];
 	char name_buf[16];
-	char *writer_argv[4];
+	char *writer_argv[3];
 
-	compose_writer_args(id, value_pipe_id, name_buf, writer_id_buf, value_pipe_buf, writer_argv);
+	compose_writer_args(id, name_buf, writer_id_buf, writer_argv);
 
-	pid_t pid = (pid_t) sys_createProcess((uint64_t) mvar_writer, writer_argv, 3, priority, background, descriptors);
+	pid_t pid = (pid_t) sys_createProcess((uint64_t) mvar_writer, writer_argv, 2, priority, background, descriptors);
 	if (pid < 0) {
 		log_spawn_error("escritor", id);
 	}
 }
 
-static void spawn_reader(int id, int value_pipe_id, int16_t descriptors[], uint8_t priority, char background) {
+static void spawn_reader(int id, int16_t descriptors[], uint8_t priority, char background) {
 	char reader_id_buf[12];
-	char value_pipe_buf[12];
 	char name_buf[24];
-	char *reader_argv[4];
-	compose_reader_args(id, value_pipe_id, name_buf, reader_id_buf, value_pipe_buf, reader_argv);
+	char *reader_argv[3];
+	compose_reader_args(id, name_buf, reader_id_buf, reader_argv);
 
-	pid_t pid = (pid_t) sys_createProcess((uint64_t) mvar_reader, reader_argv, 3, priority, background, descriptors);
+	pid_t pid = (pid_t) sys_createProcess((uint64_t) mvar_reader, reader_argv, 2, priority, background, descriptors);
 	if (pid < 0) {
 		log_spawn_error("lector", id);
 	}
 }
 
-static void compose_writer_args(int id, int value_pipe_id, char *name_buf, char *writer_id_buf, char *value_pipe_buf,
-								char *argv_out[]) {
+static void compose_writer_args(int id, char *name_buf, char *writer_id_buf, char *argv_out[]) {
 	itoa((uint64_t) id, writer_id_buf, 10);
-	itoa((uint64_t) value_pipe_id, value_pipe_buf, 10);
 	strcpy(name_buf, "writer-");
 	name_buf[7] = writer_value(id);
 	name_buf[8] = '\0';
 
 	argv_out[0] = name_buf;
 	argv_out[1] = writer_id_buf;
-	argv_out[2] = value_pipe_buf;
-	argv_out[3] = NULL;
+	argv_out[2] = NULL;
 }
 
-static void compose_reader_args(int id, int value_pipe_id, char *name_buf, char *reader_id_buf, char *value_pipe_buf,
-								char *argv_out[]) {
+static void compose_reader_args(int id, char *name_buf, char *reader_id_buf, char *argv_out[]) {
 	const char *reader_label = reader_palette[id % READER_PALETTE_SIZE].name;
 	itoa((uint64_t) id, reader_id_buf, 10);
-	itoa((uint64_t) value_pipe_id, value_pipe_buf, 10);
 	strcpy(name_buf, "reader-");
 	strcpy(name_buf + 7, reader_label);
 
 	argv_out[0] = name_buf;
 	argv_out[1] = reader_id_buf;
-	argv_out[2] = value_pipe_buf;
-	argv_out[3] = NULL;
+	argv_out[2] = NULL;
 }
 
 static uint64_t mvar_manager(int argc, char **argv) {
@@ -168,23 +160,16 @@ static uint64_t mvar_manager(int argc, char **argv) {
 		return -1;
 	}
 
-	int value_pipe_id = sys_pipe_create();
-	if (value_pipe_id < 0) {
-		printf("[mvar] Error creando pipe principal.\n");
-		sys_exit();
-		return -1;
-	}
-
 	int16_t io_descriptors[] = {STDIN, STDOUT, STDERR};
 	uint8_t process_priority = 3;
 	char background = 1;
 
 	for (int i = 0; i < writer_count; i++) {
-		spawn_writer(i, value_pipe_id, io_descriptors, process_priority, background);
+		spawn_writer(i, io_descriptors, process_priority, background);
 	}
 
 	for (int i = 0; i < reader_count; i++) {
-		spawn_reader(i, value_pipe_id, io_descriptors, process_priority, background);
+		spawn_reader(i, io_descriptors, process_priority, background);
 	}
 
 	sys_exit();
@@ -192,20 +177,21 @@ static uint64_t mvar_manager(int argc, char **argv) {
 }
 
 static uint64_t mvar_writer(int argc, char **argv) {
-	if (argc < 3 || argv == NULL || argv[1] == NULL || argv[2] == NULL) {
+	if (argc < 2 || argv == NULL || argv[1] == NULL) {
 		sys_exit();
 		return -1;
 	}
 
 	int writer_id = (int) str_to_uint32(argv[1]);
-	int value_pipe = atoi(argv[2]);
+	// La cola se libera sola cuando terminan todos los escritores y lectores
+	int value_queue = sys_mq_open(MVAR_QUEUE_NAME, MVAR_DEPTH, MVAR_VALUE_BYTES);
 	char produced_value;
 
 	while (1) {
 		random_pause();
 
 		produced_value = writer_value(writer_id);
-		if (!pipe_write_all(value_pipe, &produced_value, MVAR_VALUE_BYTES)) {
+		if (!mvar_put(value_queue, produced_value)) {
 			break;
 		}
 	}
@@ -215,20 +201,20 @@ static uint64_t mvar_writer(int argc, char **argv) {
 }
 
 static uint64_t mvar_reader(int argc, char **argv) {
-	if (argc < 3 || argv == NULL || argv[1] == NULL || argv[2] == NULL) {
+	if (argc < 2 || argv == NULL || argv[1] == NULL) {
 		sys_exit();
 		return -1;
 	}
 
 	int reader_id = (int) str_to_uint32(argv[1]);
-	int value_pipe = atoi(argv[2]);
+	int value_queue = sys_mq_open(MVAR_QUEUE_NAME, MVAR_DEPTH, MVAR_VALUE_BYTES);
 	Color reader_font = reader_color(reader_id);
 	char consumed_value;
 
 	while (1) {
 		random_pause();
 
-		if (!pipe_read_all(value_pipe, &consumed_value, MVAR_VALUE_BYTES)) {
+		if (!mvar_take(value_queue, &consumed_value)) {
 			break;
 		}
 
@@ -8,6 +8,9 @@
 #include "include/tests.h"
 #include <stdint.h>
 
+#define IO_CHUNK 128 /* Bytes que cat, wc y filter piden por cada lectura */
+#define SPLICE_CHUNK 0x10000 /* Maximo que cat le pide mover a cada splice: la capacidad mas grande de un pipe */
+
 static uint64_t clear();
 static uint64_t ps();
 static uint64_t loop(int argc, char **argv);
@@ -15,6 +18,7 @@ static uint64_t cat();
 static uint64_t wc();
 static uint64_t is_vowel(char c);
 static uint64_t filter();
+static int readChunk(char *buffer, int *eof);
 static uint64_t run_test_mm(int argc, char **argv);
 static uint64_t run_test_processes(int argc, char **argv);
 static uint64_t run_test_priority(int argc, char **argv);
@@ -58,8 +62,9 @@ static uint64_t ps() {
 	}
 
 	for (uint16_t i = 0; i < qty; i++) {
-		printf("PID:%d  NAME:%s  STATUS:%d  PRIO:%d\n", (int) list[i].pid, list[i].name ? list[i].name : "(null)",
-			   (int) list[i].status, (int) list[i].priority);
+		printf("PID:%d  NAME:%s  STATUS:%d  PRIO:%d  MEM:%u\n", (int) list[i].pid,
+			   list[i].name ? list[i].name : "(null)", (int) list[i].status, (int) list[i].priority,
+			   list[i].memoryUsage);
 
 		if (list[i].name) {
 			sys_mm_free(list[i].name);
@@ -111,10 +116,23 @@ pid_t handle_cat(char **argv, int argc, int ground, int stdin, int stdout) {
 }
 
 static uint64_t cat() {
-	int c;
-	while ((c = getchar()) != EOF) {
-		if (c != 0) {
-			putchar(c);
+	// Si la entrada es un pipe los datos pasan al destino dentro del kernel, sin copiarse aca
+	int64_t moved = sys_splice(STDIN, STDOUT, SPLICE_CHUNK);
+	if (moved != -1) {
+		while (moved > 0) {
+			moved = sys_splice(STDIN, STDOUT, SPLICE_CHUNK);
+		}
+		sys_exit();
+		return 0;
+	}
+
+	char buffer[IO_CHUNK];
+	int eof = 0;
+	while (!eof) {
+		int n = readChunk(buffer, &eof);
+		// -1 es que del otro lado del pipe ya no queda quien lea
+		if (n > 0 && sys_write_buffer(STDOUT, buffer, n) == -1) {
+			break;
 		}
 	}
 	sys_exit();
@@ -132,23 +150,22 @@ pid_t handle_wc(char **argv, int argc, int ground, int stdin, int stdout) {
 
 static uint64_t wc() {
 	int lines = 1;
-	int c;
+	char buffer[IO_CHUNK];
+	int eof = 0;
 
-	while ((c = getchar()) != EOF) {
-		if (c != 0) {
-			if (c == '\n') {
+	while (!eof) {
+		int n = readChunk(buffer, &eof);
+		for (int i = 0; i < n; i++) {
+			if (buffer[i] == '\n') {
 				lines++;
 			}
-			putchar(c);
+		}
+		if (n > 0 && sys_write_buffer(STDOUT, buffer, n) == -1) {
+			break;
 		}
 	}
 	printf("La cantidad de lineas es: %d\n", lines);
 
-	// Hacer varios yields para asegurar que el printf se complete
-	for (int i = 0; i < 100; i++) {
-		sys_yield();
-	}
-
 	sys_exit();
 	return 0;
 }
@@ -169,11 +186,19 @@ pid_t handle_filter(char **argv, int argc, int ground, int stdin, int stdout) {
 }
 
 static uint64_t filter() {
-	int c;
-
-	while ((c = getchar()) != EOF) {
-		if (!is_vowel(c)) {
-			putchar(c);
+	char buffer[IO_CHUNK];
+	int eof = 0;
+
+	while (!eof) {
+		int n = readChunk(buffer, &eof);
+		int kept = 0;
+		for (int i = 0; i < n; i++) {
+			if (!is_vowel(buffer[i])) {
+				buffer[kept++] = buffer[i];
+			}
+		}
+		if (kept > 0 && sys_write_buffer(STDOUT, buffer, kept) == -1) {
+			break;
 		}
 	}
 
@@ -181,6 +206,31 @@ static uint64_t filter() {
 	return 0;
 }
 
+/**
+ * @brief Lee de STDIN lo que haya disponible, hasta IO_CHUNK bytes, con una sola llamada al kernel
+ * @param buffer: Destino de IO_CHUNK bytes
+ * @param eof: Se pone en 1 cuando la entrada termino
+ * @return Cantidad de bytes validos en buffer, sin contar el EOF ni los 0 que manda el teclado
+ */
+static int readChunk(char *buffer, int *eof) {
+	int64_t n = sys_read_buffer(STDIN, buffer, IO_CHUNK);
+	if (n <= 0) {
+		*eof = 1;
+		return 0;
+	}
+	int length = 0;
+	for (int64_t i = 0; i < n; i++) {
+		if (buffer[i] == (char) EOF) {
+			*eof = 1;
+			break;
+		}
+		if (buffer[i] != 0) {
+			buffer[length++] = buffer[i];
+		}
+	}
+	return length;
+}
+
 /* ------------------------ TEST_MM ------------------------ */
 
 pid_t handle_test_mm(char **argv, int argc, int ground, int stdin, int stdout) {
@@ -17,13 +17,13 @@
 #define MAX_CHARS 256
 #define BUFFER 1000
 #define IS_BUILT_IN(i) ((i) >= HELP && (i) <= FONT_SIZE)
-#define CANT_INSTRUCTIONS 21
-#define CANT_BUILTIN 7
-#define CANT_PROCESS (CANT_INSTRUCTIONS - CANT_BUILTIN - 1)
+#define CANT_INSTRUCTIONS 20
+#define CANT_BUILTIN 9
+#define CANT_PROCESS (CANT_INSTRUCTIONS - CANT_BUILTIN)
 #define MAX_ARGS 16
 
 static int split_args(char *args, char **out_argv);
-static void separate_cmds(char **argv, char **cmd1, char **cmd2);
+static int separate_cmds(char **argv, char *cmds[][MAX_ARGS]);
 static int check_fore(char **argv, int *argc);
 static void remove_name(char **argv, int *argc);
 static void handle_piped_commands(pipeCmd *pipe_cmd);
@@ -33,6 +33,8 @@ typedef enum {
 	// built-in
 	HELP = 0,
 	MEM,
+	MEMSTATS,
+	MEMPROF,
 	KILL,
 	BLOCK,
 	UNBLOCK,
@@ -65,13 +67,14 @@ static const process_cmd instruction_handlers[CANT_PROCESS] = {
 typedef void (*built_in_cmd)(int, char **);
 
 static const built_in_cmd built_in_handlers[CANT_BUILTIN] = {
-	(built_in_cmd) bi_help,	   (built_in_cmd) bi_mem,  (built_in_cmd) bi_kill,	   (built_in_cmd) bi_block,
-	(built_in_cmd) bi_unblock, (built_in_cmd) bi_nice, (built_in_cmd) bi_fontSize,
+	(built_in_cmd) bi_help,	   (built_in_cmd) bi_mem,	  (built_in_cmd) bi_memstats, (built_in_cmd) bi_memprof,
+	(built_in_cmd) bi_kill,	   (built_in_cmd) bi_block, (built_in_cmd) bi_unblock,  (built_in_cmd) bi_nice,
+	(built_in_cmd) bi_fontSize,
 };
 
-static char *instruction_list[] = {"help",		"mem",	 "kill",	"block",	"unblock",	"nice",
-								   "font-size", "clear", "ps",		"loop",		"cat",		"wc",
-								   "filter",	"mvar",	 "testmem", "testproc", "testprio", "testsync"};
+static char *instruction_list[] = {"help",	  "mem",	  "memstats", "memprof",  "kill",	  "block",	 "unblock",
+								   "nice",	  "font-size", "clear",	  "ps",		  "loop",	  "cat",	 "wc",
+								   "filter",  "mvar",	  "testmem",  "testproc", "testprio", "testsync"};
 
 static int split_args(char *args, char **out_argv) {
 	int argc = 0;
@@ -99,23 +102,31 @@ static int split_args(char *args, char **out_argv) {
 	return argc;
 }
 
-static void separate_cmds(char **argv, char **cmd1, char **cmd2) {
-	if (!argv || !cmd1 || !cmd2)
-		return;
-
-	int sep = str_in_list("|", argv, MAX_ARGS);
+/**
+ * @brief Separa la linea en los comandos de un pipeline
+ * @param argv Palabras de la linea
+ * @param cmds Destino: un vector de argumentos terminado en NULL por cada comando
+ * @return Cantidad de comandos, o -1 si alguno quedo vacio o son mas de MAX_PIPELINE_STAGES
+ */
+static int separate_cmds(char **argv, char *cmds[][MAX_ARGS]) {
+	if (!argv || !cmds)
+		return -1;
 
+	int count = 0;
 	int c = 0;
-	for (int j = 0; j < sep && j < MAX_ARGS; j++) {
-		cmd1[c++] = argv[j];
-	}
-	cmd1[c] = NULL;
-
-	c = 0;
-	for (int j = sep + 1; j < MAX_ARGS && argv[j]; j++) {
-		cmd2[c++] = argv[j];
+	for (int j = 0; j <= MAX_ARGS; j++) {
+		if (j == MAX_ARGS || argv[j] == NULL || strcmp(argv[j], "|") == 0) {
+			if (c == 0 || count == MAX_PIPELINE_STAGES)
+				return -1;
+			cmds[count++][c] = NULL;
+			c = 0;
+			if (j == MAX_ARGS || argv[j] == NULL)
+				break;
+			continue;
+		}
+		cmds[count][c++] = argv[j];
 	}
-	cmd2[c] = NULL;
+	return count;
 }
 
 static int check_fore(char **argv, int *argc) {
@@ -147,50 +158,64 @@ static void remove_name(char **argv, int *argc) {
 }
 
 static void handle_piped_commands(pipeCmd *pipe_cmd) {
-	if (pipe_cmd->cmd1.instruction == -1 || pipe_cmd->cmd2.instruction == -1) {
-		printErr("Comando invalido.\n");
-		sys_mm_free(pipe_cmd->cmd1.arguments);
-		sys_mm_free(pipe_cmd->cmd2.arguments);
-		sys_mm_free(pipe_cmd);
-		return;
+	for (int i = 0; i < pipe_cmd->count; i++) {
+		if (pipe_cmd->cmds[i].instruction == -1) {
+			printErr("Comando invalido en el pipe\n");
+			free(pipe_cmd);
+			return;
+		}
+		if (IS_BUILT_IN(pipe_cmd->cmds[i].instruction)) {
+			printErr("No se pueden usar comandos built-in con pipes.\n");
+			free(pipe_cmd);
+			return;
+		}
 	}
 
-	if (IS_BUILT_IN(pipe_cmd->cmd1.instruction) || IS_BUILT_IN(pipe_cmd->cmd2.instruction)) {
-		printErr("No se pueden usar comandos built-in con pipes.\n");
-		sys_mm_free(pipe_cmd->cmd1.arguments);
-		sys_mm_free(pipe_cmd->cmd2.arguments);
-		sys_mm_free(pipe_cmd);
-		return;
+	// todos los pipes se crean antes que los procesos: la etapa i escribe en pipes[i] y la siguiente lee de ahi
+	int pipes[MAX_PIPELINE_STAGES - 1];
+	for (int i = 0; i < pipe_cmd->count - 1; i++) {
+		pipes[i] = sys_pipe_create();
+		if (pipes[i] < 0) {
+			printErr("Error al crear el pipe\n");
+			for (int j = 0; j < i; j++)
+				sys_pipe_close(pipes[j]);
+			free(pipe_cmd);
+			return;
+		}
 	}
 
-	int pipe_fd = sys_pipe_create();
-	if (pipe_fd < 0) {
-		printErr("Error al crear el pipe\n");
-		sys_mm_free(pipe_cmd->cmd1.arguments);
-		sys_mm_free(pipe_cmd->cmd2.arguments);
-		sys_mm_free(pipe_cmd);
-		return;
+	// el & del ultimo comando manda todo el pipeline a background
+	int ground = pipe_cmd->cmds[pipe_cmd->count - 1].ground;
+	pid_t pids[MAX_PIPELINE_STAGES];
+	int started = 0;
+	while (started < pipe_cmd->count) {
+		command *cmd = &pipe_cmd->cmds[started];
+		int stdin = started == 0 ? STDIN : pipes[started - 1];
+		int stdout = started == pipe_cmd->count - 1 ? STDOUT : pipes[started];
+		pids[started] =
+			instruction_handlers[cmd->instruction - CLEAR](cmd->arguments, cmd->argc, ground, stdin, stdout);
+		if (pids[started] < 0) {
+			printErr("Error al ejecutar el comando.\n");
+			break;
+		}
+		started++;
 	}
 
-	// crear ambos procesos
-	// cmd1 lee de stdin (0) y escribe al pipe
-	// cmd2 lee del pipe y escribe a stdout (1)
-	pid_t pids[2];
-	pids[0] = instruction_handlers[pipe_cmd->cmd1.instruction - FONT_SIZE - 1](
-		pipe_cmd->cmd1.arguments, pipe_cmd->cmd1.argc, pipe_cmd->cmd1.ground, STDIN, pipe_fd);
-	pids[1] = instruction_handlers[pipe_cmd->cmd2.instruction - FONT_SIZE - 1](
-		pipe_cmd->cmd2.arguments, pipe_cmd->cmd2.argc, pipe_cmd->cmd2.ground, pipe_fd, STDOUT);
-
-	// Esperar a que terminen ambos procesos
-	sys_waitProcess(pids[0]);
-	sys_mm_free(pipe_cmd->cmd1.arguments);
-
-	sys_waitProcess(pids[1]);
-	sys_mm_free(pipe_cmd->cmd2.arguments);
-
-	// cerrar el pipe
-	sys_pipe_close(pipe_fd);
-	sys_mm_free(pipe_cmd);
+	// Los procesos ya tienen sus propias referencias: si la shell mantuviera las suyas los lectores nunca verian EOF.
+	// Si alguna etapa no arranco, las anteriores ven que su salida no tiene lector y terminan
+	for (int i = 0; i < pipe_cmd->count - 1; i++)
+		sys_pipe_close(pipes[i]);
+
+	// Esperar a que terminen todas las etapas
+	for (int i = 0; i < started; i++) {
+		if (pids[i] > 0)
+			sys_waitProcess(pids[i]);
+	}
+	if (!ground && started == pipe_cmd->count) {
+		printf("Pipeline ejecutado en background.\n");
+	}
+
+	free(pipe_cmd);
 }
 
 static void handle_process_command(char **argv, int argc, int inst_n) {
@@ -227,7 +252,7 @@ void run_shell() {
 	sys_clear();
 	puts(WELCOME);
 
-	char *line = sys_mm_alloc(MAX_CHARS * sizeof(char));
+	char *line = malloc(MAX_CHARS * sizeof(char));
 	if (line == NULL) {
 		printErr("Error al asignar memoria para la linea de comandos\n");
 		return;
@@ -248,18 +273,22 @@ void run_shell() {
 
 		// comando con pipes
 		if (str_in_list("|", argv, MAX_ARGS) != -1) {
-			pipeCmd *pipecmds = (pipeCmd *) sys_mm_alloc(sizeof(pipeCmd));
+			char *cmds[MAX_PIPELINE_STAGES][MAX_ARGS];
+			int count = separate_cmds(argv, cmds);
+			if (count == -1) {
+				printErr("Pipe invalido: hay un comando vacio o mas de 8 comandos\n");
+				continue;
+			}
+
+			pipeCmd *pipecmds = (pipeCmd *) malloc(sizeof(pipeCmd));
 			if (!pipecmds) {
 				printErr("Error al asignar memoria para pipeCmd\n");
 				continue;
 			}
 
-			char *cmd1[MAX_ARGS];
-			char *cmd2[MAX_ARGS];
-			separate_cmds(argv, cmd1, cmd2);
-
-			pipecmds->cmd1 = set_cmd(cmd1);
-			pipecmds->cmd2 = set_cmd(cmd2);
+			pipecmds->count = count;
+			for (int i = 0; i < count; i++)
+				pipecmds->cmds[i] = set_cmd(cmds[i]);
 
 			handle_piped_commands(pipecmds);
 			continue;
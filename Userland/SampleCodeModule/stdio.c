@@ -9,6 +9,17 @@
 #include <stdint.h>
 
 #define CURSOR_FREQ 10 /* Frecuencia en Ticks del dibujo del cursor*/
+#define OUT_BUFFER_SIZE 256
+
+/*
+ * Salida acumulada de un printf. Vive en el stack de quien imprime: los globales de userland son de todos los
+ * procesos, asi que no puede haber un buffer compartido.
+ */
+typedef struct outBuffer {
+	int fd;
+	uint64_t length;
+	char data[OUT_BUFFER_SIZE];
+} outBuffer;
 
 /**
  * @brief Funcion auxiliar para printf y printfc
@@ -18,6 +29,11 @@
  */
 static void vprintf(char *fmt, va_list args);
 
+static void bufferChar(outBuffer *out, char c);
+static void bufferString(outBuffer *out, const char *s);
+static void bufferNChars(outBuffer *out, char c, int n);
+static void flush(outBuffer *out);
+
 void putchar(char c) {
 	sys_write(STDOUT, c);
 }
@@ -27,13 +43,11 @@ void putcharErr(char c) {
 }
 
 void puts(const char *s) {
-	while (*s)
-		putchar(*s++);
+	sys_write_buffer(STDOUT, s, strlen(s));
 }
 
 void printErr(const char *s) {
-	while (*s)
-		putcharErr(*s++);
+	sys_write_buffer(STDERR, s, strlen(s));
 }
 
 int getchar() {
@@ -58,6 +72,7 @@ void printf(char *fmt, ...) {
 
 static void vprintf(char *fmt, va_list args) {
 	char buffer[MAX_CHARS] = {0};
+	outBuffer out = {.fd = STDOUT, .length = 0};
 	char *fmtPtr = fmt;
 	while (*fmtPtr) {
 		if (*fmtPtr == '%') {
@@ -67,38 +82,39 @@ static void vprintf(char *fmt, va_list args) {
 
 			switch (*fmtPtr) {
 				case 'c': {
-					putchar(va_arg(args, int));
+					bufferChar(&out, va_arg(args, int));
 				} break;
 
 				case 'd': // decimal (con signo, pero imprimimos igual con itoa)
 				case 'u':
 					len = itoa(va_arg(args, uint64_t), buffer, 10);
-					printNChars('0', dx - len);
-					puts(buffer);
+					bufferNChars(&out, '0', dx - len);
+					bufferString(&out, buffer);
 					break;
 
 				case 'x': {
 					len = itoa(va_arg(args, uint64_t), buffer, 16);
-					printNChars('0', dx - len);
-					puts(buffer);
+					bufferNChars(&out, '0', dx - len);
+					bufferString(&out, buffer);
 				} break;
 
 				case 's': {
-					printNChars(' ', dx);
-					puts((char *) va_arg(args, char *));
+					bufferNChars(&out, ' ', dx);
+					bufferString(&out, (char *) va_arg(args, char *));
 				} break;
 
 				default: {
 					// si llega un especificador desconocido, imprimimos el carácter tal cual
-					putchar(*fmtPtr);
+					bufferChar(&out, *fmtPtr);
 				} break;
 			}
 		}
 		else {
-			putchar(*fmtPtr);
+			bufferChar(&out, *fmtPtr);
 		}
 		fmtPtr++;
 	}
+	flush(&out);
 }
 
 void printfc(Color color, char *fmt, ...) {
@@ -112,31 +128,57 @@ void printfc(Color color, char *fmt, ...) {
 }
 
 void printNChars(char c, int n) {
+	outBuffer out = {.fd = STDOUT, .length = 0};
+	bufferNChars(&out, c, n);
+	flush(&out);
+}
+
+static void bufferChar(outBuffer *out, char c) {
+	if (out->length == OUT_BUFFER_SIZE) {
+		flush(out);
+	}
+	out->data[out->length++] = c;
+}
+
+static void bufferString(outBuffer *out, const char *s) {
+	while (*s)
+		bufferChar(out, *s++);
+}
+
+static void bufferNChars(outBuffer *out, char c, int n) {
 	for (int i = 0; i < n; i++)
-		putchar(c);
+		bufferChar(out, c);
+}
+
+/**
+ * @brief Escribe lo acumulado con una sola llamada al kernel
+ */
+static void flush(outBuffer *out) {
+	if (out->length > 0) {
+		sys_write_buffer(out->fd, out->data, out->length);
+		out->length = 0;
+	}
 }
 
 int scanf(char *fmt, ...) {
 	va_list v;
 	va_start(v, fmt);
-	char c;
-	int ticks = sys_getTicks();
-	int cursorTicks = 0;
+	char c = 0;
 	char cursorDrawn = 0;
 	char buffer[MAX_CHARS];
 	uint64_t bIdx = 0;
-	while ((c = getchar()) != '\n' && bIdx < MAX_CHARS - 1) {
-		cursorTicks = sys_getTicks() - ticks;
-		if (cursorTicks > CURSOR_FREQ) {
-			ticks = sys_getTicks();
-			cursorTicks = 0;
-			if (cursorDrawn)
-				putchar('\b');
-			else
-				putchar('_');
+	// Mientras se escribe STDIN queda en modo no bloqueante: getchar devuelve 0 cuando no hay mas teclas
+	int prevFlags = sys_get_fd_flags(STDIN);
+	sys_set_fd_flags(STDIN, FD_NONBLOCK);
+	pollfd_t input = {STDIN, POLLIN, 0};
+	while (c != '\n' && bIdx < MAX_CHARS - 1) {
+		// Duerme hasta que llegue una tecla o le toque parpadear al cursor
+		if (sys_poll(&input, 1, CURSOR_FREQ) == 0) {
+			putchar(cursorDrawn ? '\b' : '_');
 			cursorDrawn = !cursorDrawn;
+			continue;
 		}
-		if (c != 0) {
+		while ((c = getchar()) != 0 && c != '\n' && bIdx < MAX_CHARS - 1) {
 			if (cursorDrawn) {
 				putchar('\b');
 				cursorDrawn = !cursorDrawn;
@@ -151,6 +193,7 @@ int scanf(char *fmt, ...) {
 			}
 		}
 	}
+	sys_set_fd_flags(STDIN, prevFlags);
 	if (cursorDrawn)
 		putchar('\b');
 	putchar('\n');
@@ -6,12 +6,16 @@ IMAGE_NAME="agodio/itba-so-multi-platform:3.0"
 PROJECT_PATH="/root"
 MM_TYPE_ARG="" 
 RUN_PVS=0
+MM_PROFILE_ARG=0
 
 # Verificar argumentos del script
 for arg in "$@"; do
   if [[ "$arg" == "--mm="* ]]; then # Parsear argumento --mm=
     MM_TYPE_ARG="${arg#--mm=}" # Extrae el valor después de '--mm=' y lo guarda
     echo ">>> Tipo de Administrador de Memoria especificado: ${MM_TYPE_ARG}"
+  elif [[ "$arg" == "--profile" ]]; then
+    MM_PROFILE_ARG=1
+    echo ">>> Profiler de memoria habilitado"
   elif [[ "$arg" == "--pvs" ]]; then
     RUN_PVS=1
     echo ">>> Analisis PVS-Studio habilitado"
@@ -27,6 +31,10 @@ if [ -n "$MM_TYPE_ARG" ]; then
   echo ">>> Pasando MM_TYPE=${MM_TYPE_ARG} a make..."
 fi
 
+if [ "$MM_PROFILE_ARG" -eq 1 ]; then
+  MAKE_COMMAND="${MAKE_COMMAND} MM_PROFILE=1"
+fi
+
 # Ejecuta los comandos dentro del contenedor Docker
 docker run --rm -v "${PWD}:/root" --privileged -ti "$IMAGE_NAME" bash -c "
   set -e